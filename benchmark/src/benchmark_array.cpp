@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/chunked_decoder.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_sink.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+std::string generate_track_uri_array(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? ",\"spotify:track:" : "\"spotify:track:") + std::to_string(1000000 + i) + "\"";
+  }
+  return json + "]";
+}
+
+std::string generate_integer_array(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? "," : "") + std::to_string(i);
+  }
+  return json + "]";
+}
+
+std::string generate_integer_map(size_t size) {
+  std::string json = "{";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? ",\"" : "\"") + std::to_string(i) + "\":" + std::to_string(i);
+  }
+  return json + "}";
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_track_uris) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto json = generate_track_uri_array(10000);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{
+    n += decode(codec, json).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_track_uris_in_chunks) {
+  const auto json = generate_track_uri_array(10000);
+  const size_t chunk_size = 16384;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{
+    auto decoder = make_chunked_decoder<std::string>();
+    const auto callback = [&](std::string &&uri) { n += uri.size(); };
+    for (size_t i = 0; i < json.size(); i += chunk_size) {
+      decoder.feed(json.data() + i, std::min(chunk_size, json.size() - i), callback);
+    }
+    decoder.finish(callback);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_integers) {
+  const auto codec = default_codec<std::vector<int64_t>>();
+  const auto json = generate_integer_array(100000);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e2, [&]{
+    n += decode(codec, json).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_map_decode_unordered_map) {
+  const auto codec = default_codec<std::unordered_map<std::string, int>>();
+  const auto json = generate_integer_map(10000);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e2, [&]{
+    n += decode(codec, json).size();
+  });
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_encode_track_uris) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto value = decode(codec, generate_track_uri_array(100000));
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e2, [&]{
+    n += encode(codec, value).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_encode_track_uris_to_sink) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto value = decode(codec, generate_track_uri_array(100000));
+  volatile size_t n = 0;
+  callback_sink sink([&](const char *, size_t size) { n += size; });
+  JSON_BENCHMARK(1e2, [&]{
+    encode(codec, value, sink);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_encode_track_uris_into_buffer) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto value = decode(codec, generate_track_uri_array(100000));
+  std::vector<char> buffer(2 * encode(codec, value).size());
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e2, [&]{
+    n += encode(codec, value, buffer.data(), buffer.size());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_encoded_size_track_uris) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto value = decode(codec, generate_track_uri_array(100000));
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e2, [&]{
+    n += encoded_size(codec, value);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -58,8 +58,7 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e5, [&] {
     encode_context context;
-    *const_cast<bool *>(&context.has_sse42) = false;
-    write_escaped(context, begin, begin + input.size());
+    write_escaped_scalar(context, begin, begin + input.size());
     n += context.size();
   });
 }
@@ -73,13 +72,57 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string_sse42) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e5, [&] {
     encode_context context;
-    write_escaped(context, begin, begin + input.size());
+    write_escaped_sse42(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string_avx2) {
+  const auto input = generate_string(8192, false);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&] {
+    encode_context context;
+    write_escaped_avx2(context, begin, begin + input.size());
     n += context.size();
   });
 }
 
 #endif  // defined(json_arch_x86)
 
+#if defined(json_simd_avx512)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string_avx512) {
+  const auto input = generate_string(8192, false);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&] {
+    encode_context context;
+    write_escaped_avx512(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
+#endif  // defined(json_simd_avx512)
+
+#if defined(json_arch_arm64)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_simple_string_neon) {
+  const auto input = generate_string(8192, false);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&] {
+    encode_context context;
+    write_escaped_neon(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
+#endif  // defined(json_arch_arm64)
+
 BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string) {
   const auto input = generate_string(8192, true);
   const auto begin = input.data();
@@ -87,8 +130,7 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e5, [&] {
     encode_context context;
-    *const_cast<bool *>(&context.has_sse42) = false;
-    write_escaped(context, begin, begin + input.size());
+    write_escaped_scalar(context, begin, begin + input.size());
     n += context.size();
   });
 }
@@ -102,13 +144,57 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string_sse42) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e5, [&] {
     encode_context context;
-    write_escaped(context, begin, begin + input.size());
+    write_escaped_sse42(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string_avx2) {
+  const auto input = generate_string(8192, true);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&] {
+    encode_context context;
+    write_escaped_avx2(context, begin, begin + input.size());
     n += context.size();
   });
 }
 
 #endif  // defined(json_arch_x86)
 
+#if defined(json_simd_avx512)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string_avx512) {
+  const auto input = generate_string(8192, true);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&] {
+    encode_context context;
+    write_escaped_avx512(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
+#endif  // defined(json_simd_avx512)
+
+#if defined(json_arch_arm64)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string_neon) {
+  const auto input = generate_string(8192, true);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&] {
+    encode_context context;
+    write_escaped_neon(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
+#endif  // defined(json_arch_arm64)
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
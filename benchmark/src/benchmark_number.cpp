@@ -14,12 +14,19 @@
  * the License.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_context.hpp>
 
@@ -73,6 +80,154 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_positive_uint64_t) {
   });
 }
 
+namespace {
+
+template <typename T>
+struct encode_all final {
+  void operator()() const {
+    const auto codec = number<T>();
+    auto context = encode_context();
+    for (const auto value : values) {
+      codec.encode(context, value);
+      context.clear();
+    }
+  }
+
+  const std::vector<T> &values;
+};
+
+/**
+ * Integers with every bit pattern equally likely, which means that most of
+ * them have as many digits as the type allows.
+ */
+template <typename T>
+std::vector<T> uniform_integers() {
+  std::mt19937_64 rng(0x5eed);
+  std::uniform_int_distribution<T> distribution(
+      std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+  std::vector<T> values(10000);
+  for (auto &value : values) {
+    value = distribution(rng);
+  }
+  return values;
+}
+
+/**
+ * Integers that are mostly small, like counts, indices and enum values; the
+ * number of digits is geometrically distributed.
+ */
+template <typename T>
+std::vector<T> small_integers() {
+  std::mt19937_64 rng(0x5eed);
+  std::geometric_distribution<int> num_digits(0.5);
+  std::vector<T> values(10000);
+  for (auto &value : values) {
+    const auto digits = std::min(num_digits(rng) + 1, std::numeric_limits<T>::digits10);
+    value = static_cast<T>(rng() % static_cast<uint64_t>(std::pow(10.0, digits)));
+  }
+  return values;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_uniform_int32_t) {
+  const auto values = uniform_integers<int32_t>();
+  JSON_BENCHMARK(1e3, encode_all<int32_t>{values});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_uniform_uint64_t) {
+  const auto values = uniform_integers<uint64_t>();
+  JSON_BENCHMARK(1e3, encode_all<uint64_t>{values});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_uniform_int64_t) {
+  const auto values = uniform_integers<int64_t>();
+  JSON_BENCHMARK(1e3, encode_all<int64_t>{values});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_small_uint32_t) {
+  const auto values = small_integers<uint32_t>();
+  JSON_BENCHMARK(1e3, encode_all<uint32_t>{values});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_small_int64_t) {
+  const auto values = small_integers<int64_t>();
+  JSON_BENCHMARK(1e3, encode_all<int64_t>{values});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_double) {
+  const auto codec = number<double>();
+  JSON_BENCHMARK(1e2, [=]{
+    auto context = encode_context();
+    for (double d = 0.0; d < 1000.0; d += 0.0137) {
+      codec.encode(context, d);
+      context.clear();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_encode_double_with_6_significant_digits) {
+  const auto codec = number<double>(6);
+  JSON_BENCHMARK(1e2, [=]{
+    auto context = encode_context();
+    for (double d = 0.0; d < 1000.0; d += 0.0137) {
+      codec.encode(context, d);
+      context.clear();
+    }
+  });
+}
+
+namespace {
+
+template <typename T>
+struct decode_all final {
+  void operator()() const {
+    const auto codec = number<T>();
+    for (const auto &json : numbers) {
+      auto context = decode_context(json.data(), json.data() + json.size());
+      codec.decode(context);
+    }
+  }
+
+  const std::vector<std::string> &numbers;
+};
+
+const std::vector<std::string> short_decimals = {
+    "0.25", "123.456", "-0.000731", "42.0", "1e-3", "99.99", "-17.5", "3.14159" };
+
+const std::vector<std::string> long_decimals = {
+    "0.30000000000000004", "-2.2250738585072014e-308", "1.7976931348623157e308",
+    "6.02214076e23", "3.141592653589793", "-0.1234567890123456789" };
+
+const std::vector<std::string> short_integers = {
+    "0", "7", "42", "-13", "255", "1024", "-65536", "999999" };
+
+const std::vector<std::string> long_integers = {
+    "1466547200000", "-1466547200123", "9007199254740993", "1234567890123456789",
+    "-9223372036854775808", "20160602123456789", "4000000000000000" };
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_short_double) {
+  JSON_BENCHMARK(1e5, decode_all<double>{short_decimals});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_long_double) {
+  JSON_BENCHMARK(1e5, decode_all<double>{long_decimals});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_short_float) {
+  JSON_BENCHMARK(1e5, decode_all<float>{short_decimals});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_short_int64_t) {
+  JSON_BENCHMARK(1e5, decode_all<int64_t>{short_integers});
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_number_decode_long_int64_t) {
+  JSON_BENCHMARK(1e5, decode_all<int64_t>{long_integers});
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
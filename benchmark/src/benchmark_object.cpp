@@ -15,12 +15,17 @@
  */
 
 #include <string>
+#include <vector>
 
 #include <sstream>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/lazy.hpp>
 #include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/static_object.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
@@ -84,6 +89,258 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_many_required_field
   });
 }
 
+/*
+ * Wide objects, such as API responses, spend much of their encoding time on
+ * the keys and separators between the values.
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_encode_with_many_fields) {
+  const auto codec = required_codec(50);
+  const auto value = struct_t{ 17 };
+  encode_context context;
+  JSON_BENCHMARK(1e5, [&]{
+    context.clear();
+    codec.encode(context, value);
+  });
+}
+
+/*
+ * Keys longer than the small string optimization limit used to cost a heap
+ * allocation each, so these compare documents with short and long keys.
+ */
+
+codec::object_t<struct_t> keyed_codec(const std::string &prefix, size_t n) {
+  auto codec = codec::object<struct_t>();
+  for (size_t i = 0; i < n; i++) {
+    codec.required(prefix + std::to_string(i), &struct_t::integer);
+  }
+  return codec;
+}
+
+std::string make_keyed_json(const std::string &prefix, size_t n, bool reversed = false) {
+  std::string json = "{";
+  for (size_t i = 0; i < n; i++) {
+    const auto key = prefix + std::to_string(reversed ? n - i - 1 : i);
+    json += (i ? ",\"" : "\"") + key + "\":0";
+  }
+  return json + "}";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_short_keys) {
+  const auto codec = keyed_codec("k", 10);
+  const auto json = make_keyed_json("k", 10);
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_long_keys) {
+  const auto prefix = std::string("spotify_track_metadata_field_");
+  const auto codec = keyed_codec(prefix, 10);
+  const auto json = make_keyed_json(prefix, 10);
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+/*
+ * Fields are predicted to come in the order they were added to the codec, so
+ * this measures what a misprediction on every key costs.
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_reordered_keys) {
+  const auto prefix = std::string("spotify_track_metadata_field_");
+  const auto codec = keyed_codec(prefix, 10);
+  const auto json = make_keyed_json(prefix, 10, true);
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+/*
+ * A small type of the kind that is decoded and encoded on hot paths, with
+ * object_t and with static_object_t. Strings are left out, so that the cost
+ * of allocating them does not hide the cost of the field dispatch.
+ */
+
+struct track_t {
+  int id;
+  int duration_ms;
+  int disc_number;
+  int track_number;
+  int popularity;
+  bool playable;
+  bool is_explicit;
+};
+
+const auto track_json = std::string(
+    R"({"id":17,"duration_ms":215000,"disc_number":1,"track_number":4,)"
+    R"("popularity":68,"playable":true,"explicit":false})");
+
+object_t<track_t> dynamic_track_codec() {
+  auto codec = object<track_t>();
+  codec.required("id", &track_t::id);
+  codec.required("duration_ms", &track_t::duration_ms);
+  codec.optional("disc_number", &track_t::disc_number);
+  codec.optional("track_number", &track_t::track_number);
+  codec.optional("popularity", &track_t::popularity);
+  codec.optional("playable", &track_t::playable);
+  codec.optional("explicit", &track_t::is_explicit);
+  return codec;
+}
+
+auto static_track_codec() -> decltype(static_object<track_t>(
+    required_field("id", &track_t::id),
+    required_field("duration_ms", &track_t::duration_ms),
+    optional_field("disc_number", &track_t::disc_number),
+    optional_field("track_number", &track_t::track_number),
+    optional_field("popularity", &track_t::popularity),
+    optional_field("playable", &track_t::playable),
+    optional_field("explicit", &track_t::is_explicit))) {
+  return static_object<track_t>(
+      required_field("id", &track_t::id),
+      required_field("duration_ms", &track_t::duration_ms),
+      optional_field("disc_number", &track_t::disc_number),
+      optional_field("track_number", &track_t::track_number),
+      optional_field("popularity", &track_t::popularity),
+      optional_field("playable", &track_t::playable),
+      optional_field("explicit", &track_t::is_explicit));
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_track) {
+  const auto codec = dynamic_track_codec();
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(track_json.data(), track_json.data() + track_json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_static_object_decode_track) {
+  const auto codec = static_track_codec();
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(track_json.data(), track_json.data() + track_json.size());
+    codec.decode(context);
+  });
+}
+
+/*
+ * The same track with its keys in reverse order, so that every key is looked
+ * up instead of being the expected one.
+ */
+const auto reordered_track_json = std::string(
+    R"({"explicit":false,"playable":true,"popularity":68,"track_number":4,)"
+    R"("disc_number":1,"duration_ms":215000,"id":17})");
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_reordered_track) {
+  const auto codec = dynamic_track_codec();
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(reordered_track_json.data(), reordered_track_json.data() + reordered_track_json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_static_object_decode_reordered_track) {
+  const auto codec = static_track_codec();
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(reordered_track_json.data(), reordered_track_json.data() + reordered_track_json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_encode_track) {
+  const auto codec = dynamic_track_codec();
+  const auto track = decode(codec, track_json);
+  JSON_BENCHMARK(1e5, [&]{
+    encode(codec, track);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_static_object_encode_track) {
+  const auto codec = static_track_codec();
+  const auto track = decode(codec, track_json);
+  JSON_BENCHMARK(1e5, [&]{
+    encode(codec, track);
+  });
+}
+
+/*
+ * An album where only the id is read, with its tracks decoded eagerly or left
+ * undecoded in a lazy field, and then passed through to the encoder.
+ */
+
+template <typename tracks_type>
+struct album_t {
+  int id;
+  tracks_type tracks;
+};
+
+std::string make_album_json(size_t num_tracks) {
+  std::string json = R"({"id":3,"tracks":[)";
+  for (size_t i = 0; i < num_tracks; i++) {
+    json += (i ? "," : "") + track_json;
+  }
+  return json + "]}";
+}
+
+template <typename tracks_codec_type>
+object_t<album_t<typename tracks_codec_type::object_type>> album_codec(tracks_codec_type tracks_codec) {
+  using album_type = album_t<typename tracks_codec_type::object_type>;
+  auto codec = object<album_type>();
+  codec.required("id", &album_type::id);
+  codec.required("tracks", &album_type::tracks, std::move(tracks_codec));
+  return codec;
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_album_eagerly) {
+  const auto codec = album_codec(array<std::vector<track_t>>(dynamic_track_codec()));
+  const auto json = make_album_json(50);
+  JSON_BENCHMARK(1e4, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_album_lazily) {
+  const auto codec = album_codec(lazy(array<std::vector<track_t>>(dynamic_track_codec())));
+  const auto json = make_album_json(50);
+  JSON_BENCHMARK(1e4, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_album_lazily_unchecked) {
+  const auto codec = album_codec(lazy(array<std::vector<track_t>>(dynamic_track_codec())));
+  const auto json = make_album_json(50);
+  JSON_BENCHMARK(1e4, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.skip_unchecked = true;
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_pass_through_album_eagerly) {
+  const auto codec = album_codec(array<std::vector<track_t>>(dynamic_track_codec()));
+  const auto json = make_album_json(50);
+  JSON_BENCHMARK(1e4, [&]{
+    encode(codec, decode(codec, json));
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_pass_through_album_lazily) {
+  const auto codec = album_codec(lazy(array<std::vector<track_t>>(dynamic_track_codec())));
+  const auto json = make_album_json(50);
+  JSON_BENCHMARK(1e4, [&]{
+    encode(codec, decode(codec, json));
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
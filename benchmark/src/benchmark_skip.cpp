@@ -19,8 +19,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
 
 #include <spotify/json/benchmark/benchmark.hpp>
 
@@ -47,8 +49,7 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e6, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    *const_cast<bool *>(&context.has_sse42) = false;
-    detail::skip_any_simple_characters(context);
+    detail::skip_any_simple_characters_scalar(context);
     n += context.offset();
   });
 }
@@ -60,13 +61,55 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_sse42) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e6, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    detail::skip_any_simple_characters(context);
+    detail::skip_any_simple_characters_sse42(context);
+    n += context.offset();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_sse2) {
+  const auto json = generate_simple_string(8192);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_any_simple_characters_sse2(context);
+    n += context.offset();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_avx2) {
+  if (!cpuid().has_avx2()) {
+    return;
+  }
+
+  const auto json = generate_simple_string(8192);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_any_simple_characters_avx2(context);
     n += context.offset();
   });
 }
 
 #endif  // defined(json_arch_x86)
 
+#if defined(json_simd_avx512)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_simple_characters_avx512) {
+  if (!cpuid().has_avx512bw()) {
+    return;
+  }
+
+  const auto json = generate_simple_string(8192);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_any_simple_characters_avx512(context);
+    n += context.offset();
+  });
+}
+
+#endif  // defined(json_simd_avx512)
+
 std::string generate_whitespace_string(size_t size) {
   std::string string;
   for (size_t i = 0; i < size; i++) {
@@ -87,8 +130,7 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e6, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    *const_cast<bool *>(&context.has_sse42) = false;
-    detail::skip_any_whitespace(context);
+    detail::skip_any_whitespace_scalar(context);
     n += context.offset();
   });
 }
@@ -100,13 +142,85 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace_sse42) {
   volatile size_t n = 0;
   JSON_BENCHMARK(1e6, [&]{
     auto context = decode_context(json.data(), json.data() + json.size());
-    detail::skip_any_whitespace(context);
+    detail::skip_any_whitespace_sse42(context);
+    n += context.offset();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace_sse2) {
+  const auto json = generate_whitespace_string(8192);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_any_whitespace_sse2(context);
+    n += context.offset();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace_avx2) {
+  if (!cpuid().has_avx2()) {
+    return;
+  }
+
+  const auto json = generate_whitespace_string(8192);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_any_whitespace_avx2(context);
     n += context.offset();
   });
 }
 
 #endif  // defined(json_arch_x86)
 
+#if defined(json_simd_avx512)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_any_whitespace_avx512) {
+  if (!cpuid().has_avx512bw()) {
+    return;
+  }
+
+  const auto json = generate_whitespace_string(8192);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e6, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_any_whitespace_avx512(context);
+    n += context.offset();
+  });
+}
+
+#endif  // defined(json_simd_avx512)
+
+std::string generate_nested_value(size_t num_elements) {
+  std::string json = "[";
+  for (size_t i = 0; i < num_elements; i++) {
+    json += (i ? "," : "");
+    json += R"({"id":)" + std::to_string(i * 7919) + R"(,"name":"Track \"number\" )" + std::to_string(i) + R"(",)";
+    json += R"("tags":["rock","pop [live]"],"meta":{"duration":215.5,"explicit":false,"uri":null}})";
+  }
+  return json + "]";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_value) {
+  const auto json = generate_nested_value(100);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_value(context);
+    n += context.offset();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_skip_value_unchecked) {
+  const auto json = generate_nested_value(100);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_value_unchecked(context);
+    n += context.offset();
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
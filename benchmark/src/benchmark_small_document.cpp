@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_batch.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct small_t {
+  int id;
+  std::string uri;
+};
+
+codec::object_t<small_t> small_codec() {
+  auto codec = codec::object<small_t>();
+  codec.required("id", &small_t::id);
+  codec.required("uri", &small_t::uri);
+  return codec;
+}
+
+template <typename string_type, typename vector_type>
+struct request_t {
+  string_type method;
+  string_type path;
+  vector_type track_uris;
+};
+
+using heap_request_t = request_t<std::string, std::vector<std::string>>;
+using arena_request_t = request_t<arena_string, arena_vector<arena_string>>;
+
+template <typename T>
+codec::object_t<T> request_codec() {
+  auto codec = codec::object<T>();
+  codec.required("method", &T::method);
+  codec.required("path", &T::path);
+  codec.required("track_uris", &T::track_uris);
+  return codec;
+}
+
+const std::string request_json =
+    "{\"method\":\"POST\",\"path\":\"/v1/me/tracks/please-do-not-fit-in-sso\",\"track_uris\":["
+    "\"spotify:track:05341EWu6uHUg2BojF3Cyw\",\"spotify:track:4uLU6hMCjMI75M1A2tKUQC\","
+    "\"spotify:track:7GhIk7Il098yCjg4BQjzvb\",\"spotify:track:0VjIjW4GlUZAMYd2vXMi3b\","
+    "\"spotify:track:3n3Ppam7vgaVa1iaRUc9Lp\",\"spotify:track:2takcwOaAZWiXQijPHIx7B\"]}";
+
+std::string generate_small_document_lines(const size_t count) {
+  std::string lines;
+  for (size_t i = 0; i < count; i++) {
+    lines += "{\"id\":" + std::to_string(i) + ",\"uri\":\"spotify:track:05341EWu6uHUg2BojF3Cyw\"}\n";
+  }
+  return lines;
+}
+
+}  // namespace
+
+/*
+ * The per-call cost of setting up decode and encode contexts dominates when
+ * the documents are small, so these benchmarks keep the documents tiny.
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_context_construct) {
+  const auto json = std::string("{}");
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 100; i++) {
+      const auto context = decode_context(json.data(), json.data() + json.size());
+      n += context.remaining();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_encode_context_construct) {
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 100; i++) {
+      const auto context = encode_context(16);
+      n += context.capacity();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_small_document) {
+  const auto codec = small_codec();
+  const auto json = std::string("{\"id\":17,\"uri\":\"spotify:track:05341EWu6uHUg2BojF3Cyw\"}");
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      n += decode(codec, json).id;
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_request_document) {
+  const auto codec = request_codec<heap_request_t>();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      n += decode(codec, request_json).track_uris.size();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_request_document_with_arena) {
+  const auto codec = request_codec<arena_request_t>();
+  arena arena;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      n += decode(codec, request_json, arena).track_uris.size();
+      arena.reset();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_request_document_into) {
+  const auto codec = request_codec<heap_request_t>();
+  heap_request_t request;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      decode_into(codec, request_json, request);
+      n += request.track_uris.size();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_encode_small_document) {
+  const auto codec = small_codec();
+  const auto value = small_t{ 17, "spotify:track:05341EWu6uHUg2BojF3Cyw" };
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      n += encode(codec, value).size();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_encode_small_document_into_string) {
+  const auto codec = small_codec();
+  const auto value = small_t{ 17, "spotify:track:05341EWu6uHUg2BojF3Cyw" };
+  std::string json;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      encode_into(codec, value, json);
+      n += json.size();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_encode_small_document_into_context) {
+  const auto codec = small_codec();
+  const auto value = small_t{ 17, "spotify:track:05341EWu6uHUg2BojF3Cyw" };
+  encode_context context;
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      encode_into(codec, value, context);
+      n += context.size();
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_encode_small_document_into_buffer) {
+  const auto codec = small_codec();
+  const auto value = small_t{ 17, "spotify:track:05341EWu6uHUg2BojF3Cyw" };
+  char buffer[256];
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e5, [&]{
+    for (int i = 0; i < 10; i++) {
+      n += encode(codec, value, buffer, sizeof(buffer));
+    }
+  });
+}
+
+/*
+ * Batches of small documents, one per line, decoded on one thread and on as
+ * many threads as there are cores.
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_batch_of_lines_on_one_thread) {
+  const auto codec = small_codec();
+  const auto lines = generate_small_document_lines(100000);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(20, [&]{
+    n += decode_batch(codec, lines, batch_format::lines, 1).values.size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_batch_of_lines_on_all_threads) {
+  const auto codec = small_codec();
+  const auto lines = generate_small_document_lines(100000);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(20, [&]{
+    n += decode_batch(codec, lines).values.size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_small_batch_of_lines_on_four_threads) {
+  const auto codec = small_codec();
+  const auto lines = generate_small_document_lines(100);
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e4, [&]{
+    n += decode_batch(codec, lines, batch_format::lines, 4).values.size();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -19,10 +19,13 @@
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/string_ref.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
 
+#include <spotify/json/detail/utf8.hpp>
+
 #include <spotify/json/benchmark/benchmark.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
@@ -48,6 +51,27 @@ std::string generate_simple_json_string(size_t size) {
   return "\"" + generate_simple_string(size) + "\"";
 }
 
+std::string generate_escaped_string(size_t size) {
+  auto string = generate_simple_string(size);
+  for (size_t i = 0; i < size; i += 64) {
+    string[i] = '\n';
+  }
+  return string;
+}
+
+std::string generate_utf8_string(size_t size) {
+  std::string string;
+  string.reserve(size + 4);
+  for (size_t i = 0; string.size() < size; i++) {
+    switch (i % 4) {
+      case 0: string += "\xC3\xA5"; break;  // å
+      case 1: string += "\xE2\x82\xAC"; break;  // €
+      default: string += generate_simple_string(8); break;
+    }
+  }
+  return string;
+}
+
 /*
  * Decoding
  */
@@ -76,6 +100,77 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_simple_tiny_string) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_escaped_long_string) {
+  const auto codec = default_codec<std::string>();
+  const auto json = encode(codec, generate_escaped_string(10000));
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json_begin, json_end);
+    const auto decoded_string = codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_utf8_long_string) {
+  const auto codec = default_codec<std::string>();
+  const auto json = "\"" + generate_utf8_string(10000) + "\"";
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json_begin, json_end);
+    const auto decoded_string = codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_utf8_long_string_with_validation) {
+  const auto codec = default_codec<std::string>();
+  const auto json = "\"" + generate_utf8_string(10000) + "\"";
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json_begin, json_end);
+    context.validate_utf8 = true;
+    const auto decoded_string = codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_utf8_long_string_with_separate_validation) {
+  const auto codec = default_codec<std::string>();
+  const auto json = "\"" + generate_utf8_string(10000) + "\"";
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e5, [=]{
+    if (detail::find_invalid_utf8(json_begin, json_end) == json_end) {
+      auto context = decode_context(json_begin, json_end);
+      const auto decoded_string = codec.decode(context);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_ref_decode_simple_long_string) {
+  const auto codec = default_codec<json::string_ref>();
+  const auto json = generate_simple_json_string(10000);
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json_begin, json_end);
+    const auto decoded_string = codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_ref_decode_simple_tiny_string) {
+  const auto codec = default_codec<json::string_ref>();
+  const auto json = std::string("\"spotify:track:05341EWu6uHUg2BojF3Cyw\"");
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e5, [=]{
+    for (int i = 0; i < 100; i++) {
+      auto context = decode_context(json_begin, json_end);
+      const auto decoded_string = codec.decode(context);
+    }
+  });
+}
+
 /*
  * Encoding
  */
@@ -102,6 +197,37 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_simple_tiny_string) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_escaped_long_string) {
+  const auto codec = default_codec<std::string>();
+  const auto string = generate_escaped_string(10000);
+  auto context = encode_context(string.size() + 2);
+  JSON_BENCHMARK(1e5, [&]{
+    codec.encode(context, string);
+    context.clear();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_utf8_long_string) {
+  const auto codec = default_codec<std::string>();
+  const auto string = generate_utf8_string(10000);
+  auto context = encode_context(string.size() + 2);
+  JSON_BENCHMARK(1e5, [&]{
+    codec.encode(context, string);
+    context.clear();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_utf8_long_string_with_validation) {
+  const auto codec = default_codec<std::string>();
+  const auto string = generate_utf8_string(10000);
+  auto context = encode_context(string.size() + 2);
+  context.set_validate_utf8(true);
+  JSON_BENCHMARK(1e5, [&]{
+    codec.encode(context, string);
+    context.clear();
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/structural_index.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track_t {
+  int id;
+};
+
+codec::array_t<std::vector<track_t>, codec::object_t<track_t>> tracks_codec() {
+  auto codec = codec::object<track_t>();
+  codec.required("id", &track_t::id);
+  return codec::array<std::vector<track_t>>(codec);
+}
+
+/**
+ * A pretty-printed document with 1000 tracks, where most of each track is made
+ * up of nested metadata that the codec does not know about.
+ */
+std::string generate_tracks() {
+  std::string json = "[\n";
+  for (int i = 0; i < 1000; i++) {
+    json += (i ? ",\n" : "");
+    json += "  {\n    \"id\": " + std::to_string(i) + ",\n    \"metadata\": {\n";
+    json += "      \"album\": { \"name\": \"Album\", \"artists\": [ { \"name\": \"Artist\" } ] },\n";
+    json += "      \"markets\": [ \"SE\", \"US\", \"GB\", \"DE\", \"FR\", \"JP\", \"BR\", \"AU\" ],\n";
+    json += "      \"popularity\": [ 0.5, 0.25, 0.125, 0.0625 ],\n";
+    json += "      \"explicit\": false\n    }\n  }";
+  }
+  return json + "\n]\n";
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_structural_index_build) {
+  const auto json = generate_tracks();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{
+    n += structural_index(json.data(), json.size()).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_skipping_without_index) {
+  const auto codec = tracks_codec();
+  const auto json = generate_tracks();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{
+    n += decode(codec, json).size();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_skipping_with_index) {
+  const auto codec = tracks_codec();
+  const auto json = generate_tracks();
+  volatile size_t n = 0;
+  JSON_BENCHMARK(1e3, [&]{
+    structural_index index(json.data(), json.size());
+    n += decode(codec, index).size();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
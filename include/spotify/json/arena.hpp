@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A monotonic memory arena. Memory is handed out from large blocks by bumping
+ * a pointer, and is never freed individually. Instead, all of it is released
+ * at once with reset(), which keeps the largest block around so that the next
+ * use of the arena, e.g., for the next request, usually does not have to call
+ * malloc at all.
+ *
+ * A decode_context with an arena makes the codecs build containers that use
+ * arena_allocator from that arena, see arena_allocator. The arena is owned by
+ * the caller and must outlive everything that was decoded with it. It is not
+ * thread safe; each thread should have an arena of its own.
+ */
+class arena final {
+ public:
+  explicit arena(size_t initial_block_size = 4096);
+  arena(const arena &) = delete;
+  arena &operator=(const arena &) = delete;
+  ~arena();
+
+  json_force_inline void *allocate(const size_t size, const size_t alignment) {
+    const auto position = reinterpret_cast<uintptr_t>(_position);
+    const auto aligned = (position + alignment - 1) & ~(alignment - 1);
+    if (json_likely(aligned >= position && size <= reinterpret_cast<uintptr_t>(_end) - aligned)) {
+      _position = reinterpret_cast<char *>(aligned + size);
+      return reinterpret_cast<void *>(aligned);
+    } else {
+      return allocate_in_new_block(size, alignment);
+    }
+  }
+
+  /**
+   * Release all memory that has been allocated from the arena. Everything that
+   * was allocated from it must have been destroyed already.
+   */
+  void reset();
+
+  /**
+   * The number of bytes of memory that the arena currently holds, including
+   * the unused parts of its blocks.
+   */
+  size_t capacity() const;
+
+ private:
+  struct block;
+
+  json_never_inline void *allocate_in_new_block(size_t size, size_t alignment);
+
+  block *_blocks;
+  char *_position;
+  char *_end;
+  size_t _next_block_size;
+};
+
+/**
+ * A standard library allocator that allocates memory from an arena. A default
+ * constructed arena_allocator has no arena and falls back to operator new, so
+ * that containers with it can be default constructed, e.g., as fields of the
+ * objects that object_t decodes. The allocator propagates when a container is
+ * moved or swapped, so that moving a decoded container into such a field keeps
+ * its arena memory.
+ */
+template <typename T>
+class arena_allocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  arena_allocator() noexcept : _arena(nullptr) {}
+  explicit arena_allocator(json::arena *arena) noexcept : _arena(arena) {}
+
+  template <typename U>
+  arena_allocator(const arena_allocator<U> &other) noexcept : _arena(other.arena()) {}
+
+  T *allocate(const size_t n) {
+    if (json_unlikely(n > std::numeric_limits<size_t>::max() / sizeof(T))) {
+      throw std::bad_alloc();
+    }
+    const auto size = n * sizeof(T);
+    return static_cast<T *>(_arena ? _arena->allocate(size, alignof(T)) : ::operator new(size));
+  }
+
+  void deallocate(T *pointer, size_t) noexcept {
+    if (!_arena) {
+      ::operator delete(pointer);
+    }
+  }
+
+  json::arena *arena() const noexcept {
+    return _arena;
+  }
+
+ private:
+  json::arena *_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const arena_allocator<T> &a, const arena_allocator<U> &b) noexcept {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const arena_allocator<T> &a, const arena_allocator<U> &b) noexcept {
+  return a.arena() != b.arena();
+}
+
+using arena_string = std::basic_string<char, std::char_traits<char>, arena_allocator<char>>;
+
+template <typename T>
+using arena_vector = std::vector<T, arena_allocator<T>>;
+
+template <typename K, typename V>
+using arena_map = std::map<K, V, std::less<K>, arena_allocator<std::pair<const K, V>>>;
+
+template <typename K, typename V>
+using arena_unordered_map = std::unordered_map<
+    K, V, std::hash<K>, std::equal_to<K>, arena_allocator<std::pair<const K, V>>>;
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/value_splitter.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * How the input to a chunked_decoder is laid out. Only top-level values can be
+ * streamed: the elements of an array that is nested in an object, such as
+ * '{"items": [...]}', can not be, and such a document has to be decoded whole.
+ */
+enum class chunked_input {
+  /** The elements of a single top-level array, e.g., '[{...}, {...}]'. */
+  array_elements,
+
+  /**
+   * A sequence of values, separated by whitespace, e.g., JSON Lines. A single
+   * document is a sequence with one value.
+   */
+  value_sequence
+};
+
+/**
+ * A chunked_decoder decodes JSON that arrives in chunks, for example from a
+ * socket, without first having to buffer all of it. The chunks can be split
+ * anywhere. Each value is decoded with the codec as soon as its last byte has
+ * been fed, and is passed to a callback, so decoding overlaps with receiving
+ * the rest of the input. Only the value that is being received is buffered,
+ * so a large array of small objects can be decoded with little memory.
+ *
+ *   chunked_decoder<codec::object_t<track>> decoder(track_codec);
+ *   while (const auto size = read(fd, buffer, sizeof(buffer))) {
+ *     decoder.feed(buffer, size, [&](track &&t) { tracks.push_back(t); });
+ *   }
+ *   decoder.finish([&](track &&t) { tracks.push_back(t); });
+ *
+ * decode_exception is thrown for invalid input, with an offset that is counted
+ * from the start of the whole input. The decoder can not be used after that.
+ */
+template <typename codec_type>
+class chunked_decoder final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit chunked_decoder(
+      codec_type codec = codec_type(),
+      const chunked_input input = chunked_input::array_elements)
+      : _codec(std::move(codec)),
+        _splitter(input == chunked_input::array_elements) {}
+
+  /**
+   * Feed the next chunk of input and call the callback with each value that it
+   * completes. The chunk does not have to outlive the call.
+   */
+  template <typename callback_type>
+  void feed(const char *data, size_t size, callback_type &&callback) {
+    _splitter.push(data, size);
+    while (_splitter.next()) {
+      callback(decode_value());
+    }
+  }
+
+  template <typename string_type, typename callback_type>
+  void feed(const string_type &chunk, callback_type &&callback) {
+    feed(chunk.data(), chunk.size(), std::forward<callback_type>(callback));
+  }
+
+  /**
+   * Signal the end of the input. A number or literal at the end of a value
+   * sequence is only known to be complete at this point, so it is passed to
+   * the callback now. Throws decode_exception if the input is incomplete.
+   */
+  template <typename callback_type>
+  void finish(callback_type &&callback) {
+    if (_splitter.finish()) {
+      callback(decode_value());
+    }
+  }
+
+ private:
+  object_type decode_value() const {
+    try {
+      return decode(_codec, _splitter.value_data(), _splitter.value_size());
+    } catch (decode_exception &exception) {
+      throw decode_exception(exception, _splitter.value_offset() + exception.offset());
+    }
+  }
+
+  codec_type _codec;
+  detail::value_splitter _splitter;
+};
+
+template <typename codec_type>
+chunked_decoder<typename std::decay<codec_type>::type> make_chunked_decoder(
+    codec_type &&codec,
+    const chunked_input input = chunked_input::array_elements) {
+  return chunked_decoder<typename std::decay<codec_type>::type>(std::forward<codec_type>(codec), input);
+}
+
+template <typename value_type>
+chunked_decoder<decltype(default_codec<value_type>())> make_chunked_decoder(
+    const chunked_input input = chunked_input::array_elements) {
+  return make_chunked_decoder(default_codec<value_type>(), input);
+}
+
+}  // namespace json
+}  // namespace spotify
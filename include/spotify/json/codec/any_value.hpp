@@ -42,6 +42,10 @@ class any_value_t final {
   void encode(encode_context &context, const object_type &value) const {
     context.append(value.data(), value.size());
   }
+
+  size_t encoded_size(const object_type &value) const {
+    return value.size();
+  }
 };
 
 inline any_value_t any_value() {
@@ -28,6 +28,7 @@
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/size_hint.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -52,6 +53,28 @@ struct sequence_inserter {
   static void validate(decode_context &, state, container_type &) {
     // Nothing to validate
   }
+
+  /**
+   * Decode into the elements that the container already has, so that their
+   * memory is reused, append the ones that do not fit and erase the rest.
+   */
+  template <typename container_type, typename codec_type>
+  static void decode_into(
+      decode_context &context,
+      const codec_type &codec,
+      container_type &container) {
+    auto it = container.begin();
+    decode_comma_separated(context, '[', ']', [&]{
+      if (it != container.end()) {
+        decode_element(codec, context, *it);
+        ++it;
+      } else {
+        container.push_back(codec.decode(context));
+        it = container.end();
+      }
+    });
+    container.erase(it, container.end());
+  }
 };
 
 struct fixed_size_sequence_inserter {
@@ -73,6 +96,19 @@ struct fixed_size_sequence_inserter {
   static void validate(decode_context &context, state pos, container_type &container) {
     fail_if(context, pos != container.size(), "Too few elements in array");
   }
+
+  template <typename container_type, typename codec_type>
+  static void decode_into(
+      decode_context &context,
+      const codec_type &codec,
+      container_type &container) {
+    state pos = init_state;
+    decode_comma_separated(context, '[', ']', [&]{
+      fail_if(context, pos >= container.size(), "Too many elements in array");
+      decode_element(codec, context, container[pos++]);
+    });
+    validate(context, pos, container);
+  }
 };
 
 struct associative_inserter {
@@ -93,18 +129,29 @@ struct associative_inserter {
   static void validate(decode_context &, state, container_type &) {
     // Nothing to validate
   }
+
+  template <typename container_type, typename codec_type>
+  static void decode_into(
+      decode_context &context,
+      const codec_type &codec,
+      container_type &container) {
+    container.clear();
+    decode_comma_separated(context, '[', ']', [&]{
+      container.insert(codec.decode(context));
+    });
+  }
 };
 
 template <typename T> struct container_inserter;
 
-template <typename T>
-struct container_inserter<std::vector<T>> : public sequence_inserter {};
+template <typename T, typename allocator_type>
+struct container_inserter<std::vector<T, allocator_type>> : public sequence_inserter {};
 
-template <typename T>
-struct container_inserter<std::deque<T>> : public sequence_inserter {};
+template <typename T, typename allocator_type>
+struct container_inserter<std::deque<T, allocator_type>> : public sequence_inserter {};
 
-template <typename T>
-struct container_inserter<std::list<T>> : public sequence_inserter {};
+template <typename T, typename allocator_type>
+struct container_inserter<std::list<T, allocator_type>> : public sequence_inserter {};
 
 template <typename T, size_t Size>
 struct container_inserter<std::array<T, Size>> : public fixed_size_sequence_inserter {};
@@ -140,16 +187,27 @@ class array_t final {
 
   object_type decode(decode_context &context) const {
     using inserter = detail::container_inserter<T>;
-    object_type output;
+    auto output = detail::make_container<object_type>(context);
+    _size_hint.reserve(context, output);
     typename inserter::state state = inserter::init_state;
     detail::decode_comma_separated(context, '[', ']', [&]{
       state = inserter::insert(
           context, state, output, _inner_codec.decode(context));
     });
     inserter::validate(context, state, output);
+    _size_hint.record(output);
     return output;
   }
 
+  /**
+   * Decode into an existing container. Sequences keep their capacity and the
+   * elements they already have are decoded in place, so that, e.g., the
+   * strings in a std::vector<std::string> are reused as well.
+   */
+  void decode_into(decode_context &context, object_type &output) const {
+    detail::container_inserter<T>::decode_into(context, _inner_codec, output);
+  }
+
   void encode(encode_context &context, const object_type &array) const {
     context.append('[');
     for (const auto &element : array) {
@@ -161,8 +219,19 @@ class array_t final {
     context.append_or_replace(',', ']');
   }
 
+  size_t encoded_size(const object_type &array) const {
+    size_t size = 1;  // '[', and the last ',' is replaced by ']'
+    for (const auto &element : array) {
+      if (json_likely(detail::should_encode(_inner_codec, element))) {
+        size += detail::encoded_size(_inner_codec, element) + 1;
+      }
+    }
+    return (size == 1 ? 2 : size);
+  }
+
  private:
   codec_type _inner_codec;
+  detail::size_hint<T> _size_hint;
 };
 
 template <typename T, typename codec_type>
@@ -172,24 +241,24 @@ array_t<T, typename std::decay<codec_type>::type> array(codec_type &&inner_codec
 
 }  // namespace codec
 
-template <typename T>
-struct default_codec_t<std::vector<T>> {
-  static decltype(codec::array<std::vector<T>>(default_codec<T>())) codec() {
-    return codec::array<std::vector<T>>(default_codec<T>());
+template <typename T, typename allocator_type>
+struct default_codec_t<std::vector<T, allocator_type>> {
+  static decltype(codec::array<std::vector<T, allocator_type>>(default_codec<T>())) codec() {
+    return codec::array<std::vector<T, allocator_type>>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::deque<T>> {
-  static decltype(codec::array<std::deque<T>>(default_codec<T>())) codec() {
-    return codec::array<std::deque<T>>(default_codec<T>());
+template <typename T, typename allocator_type>
+struct default_codec_t<std::deque<T, allocator_type>> {
+  static decltype(codec::array<std::deque<T, allocator_type>>(default_codec<T>())) codec() {
+    return codec::array<std::deque<T, allocator_type>>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::list<T>> {
-  static decltype(codec::array<std::list<T>>(default_codec<T>())) codec() {
-    return codec::array<std::list<T>>(default_codec<T>());
+template <typename T, typename allocator_type>
+struct default_codec_t<std::list<T, allocator_type>> {
+  static decltype(codec::array<std::list<T, allocator_type>>(default_codec<T>())) codec() {
+    return codec::array<std::list<T, allocator_type>>(default_codec<T>());
   }
 };
 
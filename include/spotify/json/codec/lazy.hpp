@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/lazy.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * A codec for lazy values. Decoding only skips past the value, like any_value_t
+ * does, and the inner codec decodes it when it is first accessed. See lazy.
+ */
+template <typename codec_type>
+class lazy_t final {
+ public:
+  using object_type = json::lazy<typename codec_type::object_type>;
+
+  explicit lazy_t(codec_type inner_codec)
+      : _decoder(std::make_shared<decoder>(std::move(inner_codec))) {}
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    detail::skip_value(context);
+    return object_type(begin, context.position - begin, _decoder, context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    if (value._data) {
+      context.append(value._data, value._size);
+    } else {
+      _decoder->inner_codec.encode(context, value.get());
+    }
+  }
+
+  size_t encoded_size(const object_type &value) const {
+    return (value._data ? value._size : detail::encoded_size(_decoder->inner_codec, value.get()));
+  }
+
+  bool should_encode(const object_type &value) const {
+    return (value._data || detail::should_encode(_decoder->inner_codec, value.get()));
+  }
+
+ private:
+  using value_type = typename codec_type::object_type;
+
+  class decoder final : public detail::lazy_decoder<value_type> {
+   public:
+    explicit decoder(codec_type inner_codec)
+        : inner_codec(std::move(inner_codec)) {}
+
+    value_type decode(decode_context &context) const override {
+      return inner_codec.decode(context);
+    }
+
+    const codec_type inner_codec;
+  };
+
+  std::shared_ptr<const decoder> _decoder;
+};
+
+template <typename codec_type>
+lazy_t<typename std::decay<codec_type>::type> lazy(codec_type &&inner_codec) {
+  return lazy_t<typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
+}
+
+}  // namespace codec
+
+template <typename T>
+struct default_codec_t<lazy<T>> {
+  static decltype(codec::lazy(default_codec<T>())) codec() {
+    return codec::lazy(default_codec<T>());
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -21,10 +21,12 @@
 #include <unordered_map>
 
 #include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/string_ref.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/size_hint.hpp>
 
 namespace spotify {
 namespace json {
@@ -34,10 +36,13 @@ template <typename T, typename codec_type>
 class map_t final {
  public:
   using object_type = T;
+  using key_type = typename T::key_type;
 
   static_assert(
-      std::is_same<typename T::key_type, std::string>::value,
-      "Map key type must be string");
+      std::is_same<key_type, std::string>::value ||
+      std::is_same<key_type, json::arena_string>::value ||
+      std::is_same<key_type, json::string_ref>::value,
+      "Map key type must be string, arena_string or string_ref");
   static_assert(
       std::is_convertible<
           typename T::mapped_type,
@@ -54,20 +59,36 @@ class map_t final {
 
   object_type decode(decode_context &context) const {
     using value_type = typename object_type::value_type;
-    object_type output;
-    detail::decode_object<string_t>(
+    auto output = detail::make_container<object_type>(context);
+    _size_hint.reserve(context, output);
+    detail::decode_object<key_codec_type>(
         context,
-        [&](std::string &&key) {
+        [&](key_type &&key) {
           output.insert(value_type(std::move(key), _inner_codec.decode(context)));
         });
+    _size_hint.record(output);
     return output;
   }
 
+  /**
+   * Decode into an existing map. The map is cleared first; hash maps keep
+   * their bucket array, so refilling them does not have to rehash.
+   */
+  void decode_into(decode_context &context, object_type &output) const {
+    using value_type = typename object_type::value_type;
+    output.clear();
+    detail::decode_object<key_codec_type>(
+        context,
+        [&](key_type &&key) {
+          output.insert(value_type(std::move(key), _inner_codec.decode(context)));
+        });
+  }
+
   void encode(encode_context &context, const object_type &map) const {
     context.append('{');
     for (const auto &element : map) {
       if (json_likely(detail::should_encode(_inner_codec, element.second))) {
-        _string_codec.encode(context, element.first);
+        _key_codec.encode(context, element.first);
         context.append(':');
         _inner_codec.encode(context, element.second);
         context.append(',');
@@ -76,9 +97,23 @@ class map_t final {
     context.append_or_replace(',', '}');
   }
 
+  size_t encoded_size(const object_type &map) const {
+    size_t size = 1;  // '{', and the last ',' is replaced by '}'
+    for (const auto &element : map) {
+      if (json_likely(detail::should_encode(_inner_codec, element.second))) {
+        size += detail::encoded_size(_key_codec, element.first) + 1;
+        size += detail::encoded_size(_inner_codec, element.second) + 1;
+      }
+    }
+    return (size == 1 ? 2 : size);
+  }
+
  private:
-  string_t _string_codec;
+  using key_codec_type = decltype(default_codec<key_type>());
+
+  key_codec_type _key_codec;
   codec_type _inner_codec;
+  detail::size_hint<T> _size_hint;
 };
 
 template <typename T, typename codec_type>
@@ -88,17 +123,21 @@ map_t<T, typename std::decay<codec_type>::type> map(codec_type &&inner_codec) {
 
 }  // namespace codec
 
-template <typename T>
-struct default_codec_t<std::map<std::string, T>> {
-  static decltype(codec::map<std::map<std::string, T>>(default_codec<T>())) codec() {
-    return codec::map<std::map<std::string, T>>(default_codec<T>());
+template <typename K, typename T, typename compare_type, typename allocator_type>
+struct default_codec_t<std::map<K, T, compare_type, allocator_type>> {
+  using map_type = std::map<K, T, compare_type, allocator_type>;
+
+  static decltype(codec::map<map_type>(default_codec<T>())) codec() {
+    return codec::map<map_type>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::unordered_map<std::string, T>> {
-  static decltype(codec::map<std::unordered_map<std::string, T>>(default_codec<T>())) codec() {
-    return codec::map<std::unordered_map<std::string, T>>(default_codec<T>());
+template <typename K, typename T, typename hash_type, typename equal_type, typename allocator_type>
+struct default_codec_t<std::unordered_map<K, T, hash_type, equal_type, allocator_type>> {
+  using map_type = std::unordered_map<K, T, hash_type, equal_type, allocator_type>;
+
+  static decltype(codec::map<map_type>(default_codec<T>())) codec() {
+    return codec::map<map_type>(default_codec<T>());
   }
 };
 
@@ -18,7 +18,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -26,7 +28,9 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_float.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_float.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/encode_integer.hpp>
 #include <spotify/json/encode_context.hpp>
@@ -65,7 +69,53 @@ class floating_point_t {
  public:
   using object_type = T;
 
+  /**
+   * Floating point numbers are encoded with the fewest digits needed to decode
+   * them back to the same value. If 'significant_digits' is non-zero, numbers
+   * are instead rounded to at most that many significant digits, which can save
+   * a lot of space when the full precision is not needed.
+   */
+  explicit floating_point_t(const unsigned significant_digits = 0)
+      : _significant_digits(significant_digits) {}
+
   object_type decode(decode_context &context) const {
+    object_type result;
+    const char *number_end;
+    if (json_likely(decode_float_fast(context.position, context.end, result, number_end))) {
+      context.position = number_end;
+      return result;
+    }
+    return decode_slow(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    // Floats are widened to doubles, so 0.1f is written as 0.10000000149011612,
+    // unless the number of significant digits is limited.
+    detail::fail_if(context, !std::isfinite(value), "Special values like 'Infinity' or 'NaN' are not supported in JSON.");
+    if (json_likely(!_significant_digits)) {
+      encode_double_shortest(context, value);
+    } else {
+      encode_double_precision(context, value, _significant_digits);
+    }
+  }
+
+  /**
+   * The shortest form of a number is only known once it has been found, so
+   * the number is encoded into a buffer on the stack and measured.
+   */
+  size_t encoded_size(const object_type &value) const {
+    char buffer[64];  // encode_double_*(...) reserve 48 bytes
+    encode_context context(buffer, sizeof(buffer));
+    encode(context, value);
+    return context.size();
+  }
+
+ private:
+  /**
+   * Numbers that decode_float_fast(...) cannot handle, which are rare, are
+   * decoded with double-conversion.
+   */
+  json_never_inline static object_type decode_slow(decode_context &context) {
     using atod_converter = double_conversion::StringToDoubleConverter;
     static const atod_converter converter(
         atod_converter::ALLOW_TRAILING_JUNK,
@@ -85,27 +135,7 @@ class floating_point_t {
     return result;
   }
 
-  void encode(encode_context &context, const object_type &value) const {
-    // The maximum buffer size required to emit a double in base 10, for decimal
-    // and exponential representations, is 25 bytes; based on the settings used
-    // below for the DoubleToStringConverter. We add another byte for the null
-    // terminator, but it is not actually needed because we don't finalize the
-    // builder.
-    const auto max_required_size = 26;
-    const auto p = reinterpret_cast<char *>(context.reserve(max_required_size));
-
-    // The converter is based on the ECMAScript converter, but will not convert
-    // special values, like Infinity and NaN, since JSON does not support those.
-    using dtoa_converter = double_conversion::DoubleToStringConverter;
-    const dtoa_converter converter(
-        dtoa_converter::UNIQUE_ZERO | dtoa_converter::EMIT_POSITIVE_EXPONENT_SIGN,
-        nullptr, nullptr, 'e', -6, 21, 6, 0);
-
-    using dtoa_builder = double_conversion::StringBuilder;
-    dtoa_builder builder(p, max_required_size);
-    detail::fail_if(context, !converter.ToShortest(value, &builder), "Special values like 'Infinity' or 'NaN' are supported in JSON.");
-    context.advance(builder.position());
-  }
+  unsigned _significant_digits;
 };
 
 template <typename T, bool is_positive>
@@ -130,6 +160,36 @@ struct integer_ops<T, false> {
   }
 };
 
+/**
+ * Range checks and conversion for integers that have been parsed as unsigned
+ * magnitudes, i.e., without their sign.
+ */
+template <typename T, bool is_positive>
+struct magnitude_ops {
+  static json_force_inline bool is_overflow(uint64_t magnitude) {
+    return (magnitude > static_cast<uint64_t>(std::numeric_limits<T>::max()));
+  }
+
+  static json_force_inline T to_integer(uint64_t magnitude) {
+    return static_cast<T>(magnitude);
+  }
+};
+
+template <typename T>
+struct magnitude_ops<T, false> {
+  static json_force_inline bool is_overflow(uint64_t magnitude) {
+    // -(min + 1) + 1 avoids overflowing the signed type for min = -2^63.
+    const auto max_magnitude = static_cast<uint64_t>(-(std::numeric_limits<T>::min() + 1)) + 1;
+    return (magnitude > max_magnitude);
+  }
+
+  static json_force_inline T to_integer(uint64_t magnitude) {
+    return (magnitude ?
+        static_cast<T>(-static_cast<int64_t>(magnitude - 1) - 1) :
+        T(0));
+  }
+};
+
 template <typename T>
 json_force_inline bool is_invalid_digit(T digit) {
   const auto forced_positive = static_cast<unsigned>(digit);
@@ -148,6 +208,45 @@ json_force_inline iterator_type find_non_digit(const iterator_type begin, const
   });
 }
 
+/**
+ * Check if all eight bytes of 'chunk' are digit characters ('0' through '9').
+ * The bytes are expected in memory order, i.e., as loaded by load_chunk(...).
+ */
+json_force_inline bool is_eight_digits(const uint64_t chunk) {
+  return (((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL);
+}
+
+/**
+ * Convert eight digit characters into their integer value, with three
+ * multiplications instead of eight, by combining pairs of digits, then pairs of
+ * pairs and so on (SWAR, SIMD within a register). The chunk must have been
+ * checked with is_eight_digits(...).
+ */
+json_force_inline uint32_t parse_eight_digits(uint64_t chunk) {
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 0x000F424000000064ULL;  // 100 + (1000000 << 32)
+  const uint64_t mul2 = 0x0000271000000001ULL;  // 1 + (10000 << 32)
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+  return static_cast<uint32_t>(chunk);
+}
+
+/**
+ * Load eight bytes so that the first byte ends up in the least significant bits,
+ * regardless of the endianness of the machine.
+ */
+json_force_inline uint64_t load_chunk(const char *data) {
+  uint64_t chunk;
+  std::memcpy(&chunk, data, sizeof(chunk));
+#if defined(json_big_endian)
+  chunk = __builtin_bswap64(chunk);
+#endif  // defined(json_big_endian)
+  return chunk;
+}
+
 /**
  * Calculate 'exp_10(e, v) = v * 10^e', throwing a decode_exception if the value
  * overflows the integer type. This function executes in linear time over the
@@ -364,33 +463,58 @@ json_never_inline T decode_integer_tricky(decode_context &context, const char *i
  * If the parsed number is too large to fit in the given integer type, a
  * decode_exception is thrown. Decimal digits are simply discarded if they are
  * not used, i.e., if there is no positive exponent.
+ *
+ * The digits are accumulated without their sign in a 64 bit integer, so that
+ * the overflow check only has to be done once, at the end. Up to 19 digits fit
+ * in it; longer numbers are handed over to the tricky parser. By then we know
+ * that no exponent follows, so an overflow is final. Integers that are at least
+ * 32 bits wide are parsed eight digits at a time when possible, since IDs and
+ * timestamps tend to be long.
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_integer(decode_context &context) {
-  using intops = integer_ops<T, is_positive>;
   const auto b = context.position;
   const auto c = next(context);
-  const auto i = to_integer<T>(c);
+  const auto i = to_integer<int>(c);
   fail_if(context, is_invalid_digit(i), "Invalid integer");
-  T value = intops::accumulate(0, i);
 
-  while (json_likely(context.remaining())) {
-    const auto c = peek_unchecked(context);
-    const auto i = to_integer<T>(c);
+  const auto end = context.end;
+  auto p = context.position;
+  auto magnitude = static_cast<uint64_t>(i);
+
+  if (sizeof(T) >= sizeof(uint32_t)) {
+    while (end - p >= 8 && p - b <= 12) {
+      const auto chunk = load_chunk(p);
+      if (!is_eight_digits(chunk)) {
+        break;
+      }
+      magnitude = magnitude * 100000000 + parse_eight_digits(chunk);
+      p += 8;
+    }
+  }
+
+  for (; p != end; p++) {
+    const auto i = to_integer<int>(*p);
     if (is_invalid_digit(i)) {
+      const auto c = *p;
       const auto is_tricky = ((c == '.') | (c == 'e') | (c == 'E'));
-      return (json_unlikely(is_tricky) ? decode_integer_tricky<T, is_positive>(context, b) : value);
+      if (json_unlikely(is_tricky)) {
+        return decode_integer_tricky<T, is_positive>(context, b);
+      }
+      break;
     }
+    magnitude = magnitude * 10 + static_cast<uint64_t>(i);
+  }
 
-    skip_unchecked_1(context);
-    const auto old_value = value;
-    value = intops::accumulate(value * 10, i);
-    if (json_unlikely(intops::is_overflow(old_value, value))) {
-      return decode_integer_tricky<T, is_positive>(context, b);
-    }
+  if (json_unlikely(p - b > 19)) {
+    return decode_integer_tricky<T, is_positive>(context, b);
   }
 
-  return value;
+  using magops = magnitude_ops<T, is_positive>;
+  fail_if(context, magops::is_overflow(magnitude), "Integer overflow");
+
+  context.position = p;
+  return magops::to_integer(magnitude);
 }
 
 template <typename T>
@@ -419,6 +543,10 @@ class integer_t<T, true, false> {
   json_force_inline void encode(encode_context &context, const object_type value) const {
     encode_positive_integer(context, value);
   }
+
+  json_force_inline size_t encoded_size(const object_type value) const {
+    return encoded_positive_integer_size(value);
+  }
 };
 
 template <typename T>
@@ -439,6 +567,12 @@ class integer_t<T, true, true> {
       encode_positive_integer(context, value);
     }
   }
+
+  json_force_inline size_t encoded_size(const object_type value) const {
+    return (value < 0 ?
+        encoded_negative_integer_size(value) :
+        encoded_positive_integer_size(value));
+  }
 };
 
 template <typename T>
@@ -459,10 +593,18 @@ class number_t final : public detail::integer_t<T,
 
 template <>
 class number_t<float> final : public detail::floating_point_t<float> {
+ public:
+  number_t() = default;
+  explicit number_t(const unsigned significant_digits)
+      : floating_point_t(significant_digits) {}
 };
 
 template <>
 class number_t<double> final : public detail::floating_point_t<double> {
+ public:
+  number_t() = default;
+  explicit number_t(const unsigned significant_digits)
+      : floating_point_t(significant_digits) {}
 };
 
 template <typename T>
@@ -470,6 +612,14 @@ number_t<T> number() {
   return number_t<T>();
 }
 
+template <typename T>
+number_t<T> number(const unsigned significant_digits) {
+  static_assert(
+      std::is_floating_point<T>::value,
+      "Only floating point numbers can be encoded with limited precision");
+  return number_t<T>(significant_digits);
+}
+
 }  // namespace codec
 
 template <typename T>
@@ -16,12 +16,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -30,6 +30,8 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/bitset.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/key_matcher.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_value.hpp>
 #include <spotify/json/encode_context.hpp>
@@ -69,19 +71,163 @@ class object_t final {
     add_field(name, true, std::forward<args_type>(args)...);
   }
 
+  /**
+   * Skip the values of unknown fields like when decode_context::skip_unchecked
+   * is set, that is by only finding where they end, without checking that they
+   * are valid JSON. This should only be used for trusted input.
+   */
+  void skip_unknown_fields_unchecked(const bool unchecked = true) {
+    _skip_unknown_unchecked = unchecked;
+  }
+
   json_never_inline object_type decode(decode_context &context) const {
+    object_type output = construct(std::is_default_constructible<T>());
+    decode_fields<false>(context, output);
+    return output;
+  }
+
+  /**
+   * Decode into an existing object. Members that are set directly, rather than
+   * through setters, are decoded in place, so that the strings and containers
+   * they hold keep their memory. Fields that are not in the input are reset to
+   * the values of a newly constructed object, like decode(...) would have left
+   * them, but strings and containers are cleared rather than replaced.
+   */
+  json_never_inline void decode_into(decode_context &context, object_type &output) const {
+    decode_fields<true>(context, output);
+  }
+
+  /**
+   * Count the predictions, see predictions(). This is off by default, since
+   * the counters are shared by the threads that decode with the codec.
+   */
+  void count_predictions(const bool count = true) {
+    _count_predictions = count;
+  }
+
+  /**
+   * How many of the decoded keys were, and were not, the field that comes after
+   * the previously decoded field (or the first field, at the start of an
+   * object). Keys that match no field at all are counted as misses. Copies of
+   * a codec share their counters. Only counted with count_predictions().
+   */
+  struct prediction_stats {
+    size_t hits;
+    size_t misses;
+  };
+
+  prediction_stats predictions() const {
+    const auto misses = _predictions->misses.load(std::memory_order_relaxed);
+    const auto keys = _predictions->keys.load(std::memory_order_relaxed);
+    return prediction_stats{ keys - misses, misses };
+  }
+
+  /**
+   * Encode by following the plan that is made when fields are added. The keys
+   * and separators between fields that are always encoded are written as one
+   * piece each, e.g., ',"next":', so that most fields cost a single append
+   * and a single virtual call. See make_encode_plan().
+   */
+  void encode(encode_context &context, const object_type &value) const {
+    const auto literals = _encode_literals.data();
+    for (const auto &step : _encode_plan) {
+      append_literal(context, literals + step.literal_offset, step.literal_size);
+      const auto &field = _field_list[step.field_idx];
+      if (json_likely(step.is_always_encoded)) {
+        field.second->encode_value(context, value);
+      } else {
+        field.second->encode(context, field.first, value);
+      }
+    }
+
+    append_literal(context, literals + _encode_close_offset, _encode_close_size);
+    if (json_unlikely(_encode_close_with_replace)) {
+      context.append_or_replace(',', '}');
+    }
+  }
+
+  size_t encoded_size(const object_type &value) const {
+    size_t size = 1;  // '{', and the last ',' is replaced by '}'
+    for (const auto &field : _field_list) {
+      size += field.second->encoded_size(field.first, value);
+    }
+    return (size == 1 ? 2 : size);
+  }
+
+ private:
+  /**
+   * A step of the encode plan: the literal bytes that come before a field,
+   * and the field. Fields that are always encoded (their codecs have no
+   * should_encode method) only write their values; the literal holds their
+   * key and the ',' after the field before them. Other fields write their
+   * own key and a ',' after their value, if they are encoded.
+   */
+  struct encode_step {
+    size_t literal_offset;
+    size_t literal_size;
+    size_t field_idx;
+    bool is_always_encoded;
+  };
+
+  /**
+   * Counters for predictions(). They are added to once per decoded object,
+   * rather than once per key, to keep the shared cache line cool when several
+   * threads decode with the same codec and count_predictions() is on.
+   */
+  struct prediction_counters {
+    json_force_inline void record(const size_t num_keys, const size_t num_misses) {
+      keys.fetch_add(num_keys, std::memory_order_relaxed);
+      if (json_unlikely(num_misses)) {
+        misses.fetch_add(num_misses, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<size_t> keys{0};
+    std::atomic<size_t> misses{0};
+  };
+
+  template <bool in_place>
+  json_force_inline void decode_fields(decode_context &context, object_type &output) const {
     uint_fast32_t uniq_seen_required = 0;
     detail::bitset<64> seen_required(_num_required_fields);
 
-    object_type output = construct(std::is_default_constructible<T>());
-    detail::decode_object<string_t>(context, [&](const std::string &key) {
-      const auto field_it = _fields.find(key);
-      if (json_unlikely(field_it == _fields.end())) {
-        return detail::skip_value(context);
+    // When decoding in place, all fields are tracked so that the fields that
+    // are not in the input can be reset afterwards.
+    size_t uniq_seen_fields = 0;
+    detail::bitset<64> seen_fields(in_place ? _field_list.size() : 0);
+
+    // Objects are usually encoded with their fields in the order that they
+    // were added to the codec, so the next key is first compared against the
+    // field after the one that was just decoded.
+    size_t predicted_field_idx = 0;
+    size_t num_keys = 0;
+    size_t num_misses = 0;
+
+    detail::decode_comma_separated(context, '{', '}', [&]{
+      auto field_idx = predicted_field_idx;
+      num_keys++;
+      if (json_unlikely(!skip_predicted_key(context, field_idx))) {
+        num_misses++;
+        field_idx = decode_key(context);
       }
 
-      const auto &field = *(*field_it).second;
-      field.decode(context, output);
+      detail::skip_whitespace_between_tokens(context);
+      detail::skip_1(context, ':');
+      detail::skip_whitespace_between_tokens(context);
+      if (json_unlikely(field_idx == detail::key_matcher::npos)) {
+        return (_skip_unknown_unchecked ?
+            detail::skip_value_unchecked(context) :
+            detail::skip_value(context));
+      }
+
+      predicted_field_idx = field_idx + 1;
+      const auto &field = *_field_list[field_idx].second;
+      if (in_place) {
+        field.decode_into(context, output);
+        uniq_seen_fields += (1 - seen_fields.test_and_set(field_idx));
+      } else {
+        field.decode(context, output);
+      }
       if (field.is_required()) {
         const auto seen = seen_required.test_and_set(field.required_field_idx());
         uniq_seen_required += (1 - seen);  // 'seen' is 1 when the field is a duplicate; 0 otherwise
@@ -90,18 +236,62 @@ class object_t final {
 
     const auto is_missing_req_fields = (uniq_seen_required != _num_required_fields);
     detail::fail_if(context, is_missing_req_fields, "Missing required field(s)");
-    return output;
+    if (json_unlikely(_count_predictions)) {
+      _predictions->record(num_keys, num_misses);
+    }
+
+    if (in_place && json_unlikely(uniq_seen_fields != _field_list.size())) {
+      reset_missing_fields(output, seen_fields);
+    }
   }
 
-  void encode(encode_context &context, const object_type &value) const {
-    context.append('{');
-    for (const auto &field : _field_list) {
-      field.second->encode(context, field.first, value);
+  json_never_inline void reset_missing_fields(object_type &output, const detail::bitset<64> &seen_fields) const {
+    auto defaults = construct(std::is_default_constructible<T>());
+    for (size_t field_idx = 0; field_idx < _field_list.size(); field_idx++) {
+      if (!seen_fields.test(field_idx)) {
+        _field_list[field_idx].second->reset(output, defaults);
+      }
     }
-    context.append_or_replace(',', '}');
   }
 
- private:
+  /**
+   * If the input has the escaped key of the field at field_idx, skip past it
+   * and return true. The escaped key is a complete JSON string, so a match
+   * means that the input key is exactly that key.
+   */
+  json_force_inline bool skip_predicted_key(decode_context &context, const size_t field_idx) const {
+    if (json_unlikely(field_idx >= _field_list.size())) {
+      return false;
+    }
+
+    const auto &escaped_key = _field_list[field_idx].first;
+    const auto quoted_size = escaped_key.size() - 1;  // leave out the ':'
+    if (context.remaining() < quoted_size || std::memcmp(context.position, escaped_key.data(), quoted_size)) {
+      return false;
+    }
+
+    context.position += quoted_size;
+    return true;
+  }
+
+  /**
+   * Decode an object key and return the index of its field in _field_list, or
+   * npos if there is no such field. Keys without escape sequences are matched
+   * directly against the input, so that no std::string has to be allocated.
+   */
+  json_force_inline size_t decode_key(decode_context &context) const {
+    detail::skip_1(context, '"');
+    const auto key_begin = context.position;
+    detail::skip_any_simple_characters(context);
+    if (json_likely(detail::next(context, "Unterminated string") == '"')) {
+      return _matcher.find(key_begin, context.position - 1);
+    }
+
+    context.position = key_begin - 1;
+    const auto key = string().decode(context);
+    return _matcher.find(key.data(), key.data() + key.size());
+  }
+
   static std::string escape_key(const std::string &key) {
     encode_context context;
     string().encode(context, key);
@@ -109,6 +299,26 @@ class object_t final {
     return std::string(context.data(), context.size());
   }
 
+  /**
+   * Append a literal from _encode_literals. Literals of up to 16 bytes, which
+   * most are, are copied with a fixed size copy, which is a lot cheaper than a
+   * call to memcpy. _encode_literals is padded, so that it can be read past
+   * the end of the last literal. The copy is only done when there are 16 bytes
+   * left in the buffer, so that JSON that exactly fits a caller's buffer still
+   * fits.
+   */
+  json_force_inline static void append_literal(
+      encode_context &context,
+      const char *literal,
+      const size_t size) {
+    if (json_likely(size <= 16 && context.remaining() >= 16)) {
+      std::memcpy(context.reserve(16), literal, 16);
+      context.advance(size);
+    } else {
+      context.append(literal, size);
+    }
+  }
+
   json_force_inline static void append_key_to_context(
       encode_context &context,
       const std::string &escaped_key) {
@@ -124,6 +334,20 @@ class object_t final {
     context.append(',');
   }
 
+  /**
+   * The size of what append_key_to_context(...) and append_val_to_context(...)
+   * write, or zero if the value should not be encoded.
+   */
+  template <typename codec_type>
+  json_force_inline static size_t field_size(
+      const codec_type &codec,
+      const std::string &escaped_key,
+      const typename codec_type::object_type &value) {
+    return (json_likely(detail::should_encode(codec, value)) ?
+        escaped_key.size() + detail::encoded_size(codec, value) + 1 :
+        0);
+  }
+
   T construct(std::true_type is_default_constructible) const {
     // Avoid the cost of an std::function invocation if no construct function
     // is provided.
@@ -142,10 +366,24 @@ class object_t final {
     virtual ~field() = default;
 
     virtual void decode(decode_context &context, object_type &object) const = 0;
+    virtual void decode_into(decode_context &context, object_type &object) const {
+      decode(context, object);
+    }
+
+    /**
+     * Set the field of 'object' to its value in 'defaults', a newly constructed
+     * object that the value may be moved out of.
+     */
+    virtual void reset(object_type &object, object_type &defaults) const {}
     virtual void encode(
         encode_context &context,
         const std::string &escaped_key,
         const object_type &object) const = 0;
+    virtual void encode_value(encode_context &context, const object_type &object) const = 0;
+    virtual bool is_always_encoded() const = 0;
+    virtual size_t encoded_size(
+        const std::string &escaped_key,
+        const object_type &object) const = 0;
 
     json_force_inline bool is_required() const { return (_data != json_size_t_max); }
     json_force_inline size_t required_field_idx() const { return _data; }
@@ -175,6 +413,20 @@ class object_t final {
       }
     }
 
+    size_t encoded_size(
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return field_size(codec, escaped_key, typename codec_type::object_type());
+    }
+
+    void encode_value(encode_context &context, const object_type &object) const override {
+      codec.encode(context, typename codec_type::object_type());
+    }
+
+    bool is_always_encoded() const override {
+      return !detail::has_should_encode_method<codec_type>::value;
+    }
+
     codec_type codec;
   };
 
@@ -189,6 +441,14 @@ class object_t final {
       object.*member = codec.decode(context);
     }
 
+    void decode_into(decode_context &context, object_type &object) const override {
+      detail::decode_element(codec, context, object.*member);
+    }
+
+    void reset(object_type &object, object_type &defaults) const override {
+      detail::reset_element(object.*member, std::move(defaults.*member));
+    }
+
     void encode(
         encode_context &context,
         const std::string &escaped_key,
@@ -200,6 +460,20 @@ class object_t final {
       }
     }
 
+    size_t encoded_size(
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return field_size(codec, escaped_key, object.*member);
+    }
+
+    void encode_value(encode_context &context, const object_type &object) const override {
+      codec.encode(context, object.*member);
+    }
+
+    bool is_always_encoded() const override {
+      return !detail::has_should_encode_method<codec_type>::value;
+    }
+
     codec_type codec;
     member_ptr member;
   };
@@ -217,6 +491,10 @@ class object_t final {
       (object.*setter)(codec.decode(context));
     }
 
+    void reset(object_type &object, object_type &defaults) const override {
+      (object.*setter)(typename codec_type::object_type((defaults.*getter)()));
+    }
+
     void encode(
         encode_context &context,
         const std::string &escaped_key,
@@ -228,6 +506,20 @@ class object_t final {
       }
     }
 
+    size_t encoded_size(
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return field_size(codec, escaped_key, (object.*getter)());
+    }
+
+    void encode_value(encode_context &context, const object_type &object) const override {
+      codec.encode(context, (object.*getter)());
+    }
+
+    bool is_always_encoded() const override {
+      return !detail::has_should_encode_method<codec_type>::value;
+    }
+
     codec_type codec;
     getter_ptr getter;
     setter_ptr setter;
@@ -247,6 +539,10 @@ class object_t final {
       set(object, codec.decode(context));
     }
 
+    void reset(object_type &object, object_type &defaults) const override {
+      set(object, typename codec_type::object_type(get(defaults)));
+    }
+
     void encode(
         encode_context &context,
         const std::string &escaped_key,
@@ -258,6 +554,20 @@ class object_t final {
       }
     }
 
+    size_t encoded_size(
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return field_size(codec, escaped_key, get(object));
+    }
+
+    void encode_value(encode_context &context, const object_type &object) const override {
+      codec.encode(context, get(object));
+    }
+
+    bool is_always_encoded() const override {
+      return !detail::has_should_encode_method<codec_type>::value;
+    }
+
     codec_type codec;
     getter get;
     setter set;
@@ -353,15 +663,49 @@ class object_t final {
   }
 
   void save_field(const std::string &name, bool required, const std::shared_ptr<field> &f) {
-    const auto was_saved = _fields.insert(typename field_map::value_type(name, f)).second;
+    const auto was_saved = _matcher.insert(name);
     if (was_saved) {
       _field_list.push_back(std::make_pair(escape_key(name), f));
       _num_required_fields += size_t(required);
+      make_encode_plan();
     }
   }
 
+  /**
+   * Make the plan that encode(...) follows. The literal bytes that have to be
+   * written before each field are collected in _encode_literals: '{' before
+   * the first field, and for fields that are always encoded, the ',' after
+   * the field before it and the field's own key. The plan ends with a '}',
+   * which replaces the trailing ',' of the last field, if that field may not
+   * be encoded.
+   */
+  void make_encode_plan() {
+    _encode_literals.clear();
+    _encode_plan.clear();
+
+    std::string pending = "{";
+    for (size_t field_idx = 0; field_idx < _field_list.size(); field_idx++) {
+      const auto &field = _field_list[field_idx];
+      const auto is_always_encoded = field.second->is_always_encoded();
+      if (is_always_encoded) {
+        pending += field.first;
+      }
+
+      const auto literal_offset = _encode_literals.size();
+      _encode_literals += pending;
+      _encode_plan.push_back(encode_step{
+          literal_offset, pending.size(), field_idx, is_always_encoded });
+      pending = (is_always_encoded ? "," : "");
+    }
+
+    _encode_close_offset = _encode_literals.size();
+    _encode_close_with_replace = (pending != ",");
+    _encode_literals += (_encode_close_with_replace ? pending : "}");
+    _encode_close_size = _encode_literals.size() - _encode_close_offset;
+    _encode_literals.append(16, '\0');
+  }
+
   using field_vec = std::vector<std::pair<std::string, std::shared_ptr<const field>>>;
-  using field_map = std::unordered_map<std::string, std::shared_ptr<const field>>;
 
   /**
    * _construct may be unset, but only if T is default constructible. This is
@@ -370,8 +714,16 @@ class object_t final {
    */
   const std::function<T ()> _construct;
   field_vec _field_list;
-  field_map _fields;
+  detail::key_matcher _matcher;
+  std::shared_ptr<prediction_counters> _predictions = std::make_shared<prediction_counters>();
   size_t _num_required_fields = 0;
+  std::string _encode_literals = std::string("{") + std::string(16, '\0');
+  std::vector<encode_step> _encode_plan;
+  size_t _encode_close_offset = 0;
+  size_t _encode_close_size = 1;
+  bool _encode_close_with_replace = true;
+  bool _skip_unknown_unchecked = false;
+  bool _count_predictions = false;
 };
 
 template <typename T>
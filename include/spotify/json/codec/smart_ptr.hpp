@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 
+#include <spotify/json/arena.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
@@ -52,6 +54,35 @@ struct make_smart_ptr_t<std::shared_ptr<T>> {
 
 namespace detail {
 
+template <typename T>
+struct make_smart_ptr_with_context_t {
+  template <typename Obj>
+  static T make(decode_context &, Obj &&obj) {
+    return codec::make_smart_ptr_t<T>::make(std::forward<Obj>(obj));
+  }
+};
+
+/**
+ * A shared_ptr keeps its control block and object in memory from the arena of
+ * the context, if any. The object is still destroyed when the last reference
+ * goes away, so that destructors run, but the memory is only reclaimed when the
+ * arena is reset. A unique_ptr cannot do this without changing its deleter
+ * type, so unique_ptrs are always allocated with new.
+ */
+template <typename T>
+struct make_smart_ptr_with_context_t<std::shared_ptr<T>> {
+  template <typename Obj>
+  static std::shared_ptr<T> make(decode_context &context, Obj &&obj) {
+    using object_type = typename std::decay<Obj>::type;
+    if (context.arena) {
+      const auto allocator = arena_allocator<object_type>(context.arena);
+      return std::allocate_shared<object_type>(allocator, std::forward<Obj>(obj));
+    } else {
+      return codec::make_smart_ptr_t<std::shared_ptr<T>>::make(std::forward<Obj>(obj));
+    }
+  }
+};
+
 template <typename codec_type, typename T>
 class smart_ptr_t final {
  public:
@@ -61,7 +92,7 @@ class smart_ptr_t final {
       : _inner_codec(std::move(inner_codec)) {}
 
   object_type decode(decode_context &context) const {
-    return codec::make_smart_ptr_t<object_type>::make(_inner_codec.decode(context));
+    return make_smart_ptr_with_context_t<object_type>::make(context, _inner_codec.decode(context));
   }
 
   void encode(encode_context &context, const object_type &value) const {
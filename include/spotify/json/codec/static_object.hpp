@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/key_matcher.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * A field of a static_object_t: a key, a pointer to the member that holds the
+ * value and the codec for the value. Use required_field and optional_field to
+ * create them.
+ */
+template <bool required, typename class_type, typename value_type, typename codec_type>
+class static_field_t final {
+ public:
+  static constexpr bool is_required = required;
+
+  static_field_t(const std::string &name, value_type class_type::*member, codec_type codec)
+      : _name(name),
+        _escaped_name(escape_name(name)),
+        _member(member),
+        _codec(std::move(codec)) {}
+
+  json_force_inline const std::string &name() const {
+    return _name;
+  }
+
+  /**
+   * If the input has the escaped name of this field, including the quotes,
+   * skip past it and return true. The escaped name is a complete JSON string,
+   * so a match means that the input key is exactly the name.
+   */
+  json_force_inline bool skip_name(decode_context &context) const {
+    const auto quoted_size = _escaped_name.size() - 1;  // leave out the ':'
+    if (context.remaining() < quoted_size || std::memcmp(context.position, _escaped_name.data(), quoted_size)) {
+      return false;
+    }
+
+    context.position += quoted_size;
+    return true;
+  }
+
+  template <typename object_type>
+  json_force_inline void decode(decode_context &context, object_type &object) const {
+    object.*_member = _codec.decode(context);
+  }
+
+  template <typename object_type>
+  json_force_inline void encode(encode_context &context, const object_type &object) const {
+    const auto &value = object.*_member;
+    if (json_likely(detail::should_encode(_codec, value))) {
+      context.append(_escaped_name.data(), _escaped_name.size());
+      _codec.encode(context, value);
+      context.append(',');
+    }
+  }
+
+ private:
+  static std::string escape_name(const std::string &name) {
+    encode_context context;
+    string().encode(context, name);
+    context.append(':');
+    return std::string(context.data(), context.size());
+  }
+
+  std::string _name;
+  std::string _escaped_name;
+  value_type class_type::*_member;
+  codec_type _codec;
+};
+
+template <typename value_type, typename class_type>
+static_field_t<true, class_type, value_type, decltype(default_codec<value_type>())> required_field(
+    const std::string &name,
+    value_type class_type::*member) {
+  return { name, member, default_codec<value_type>() };
+}
+
+template <typename value_type, typename class_type, typename codec_type>
+static_field_t<true, class_type, value_type, typename std::decay<codec_type>::type> required_field(
+    const std::string &name,
+    value_type class_type::*member,
+    codec_type &&codec) {
+  return { name, member, std::forward<codec_type>(codec) };
+}
+
+template <typename value_type, typename class_type>
+static_field_t<false, class_type, value_type, decltype(default_codec<value_type>())> optional_field(
+    const std::string &name,
+    value_type class_type::*member) {
+  return { name, member, default_codec<value_type>() };
+}
+
+template <typename value_type, typename class_type, typename codec_type>
+static_field_t<false, class_type, value_type, typename std::decay<codec_type>::type> optional_field(
+    const std::string &name,
+    value_type class_type::*member,
+    codec_type &&codec) {
+  return { name, member, std::forward<codec_type>(codec) };
+}
+
+}  // namespace codec
+
+namespace detail {
+
+/**
+ * What the decode functions of static_object_field return when they have
+ * reached the end of the object.
+ */
+constexpr size_t end_of_static_object = json_size_t_max;
+
+/**
+ * Skip whitespace between tokens, but only call out to the whitespace kernel
+ * when there is some, since the small, hot objects that static_object_t is
+ * meant for are usually minified.
+ */
+json_force_inline void skip_static_object_whitespace(decode_context &context) {
+  const auto c = peek(context);
+  if (json_unlikely(context.index || c == ' ' || c == '\t' || c == '\n' || c == '\r')) {
+    skip_whitespace_between_tokens(context);
+  }
+}
+
+json_force_inline void skip_key_separator(decode_context &context) {
+  skip_static_object_whitespace(context);
+  skip_1(context, ':');
+  skip_static_object_whitespace(context);
+}
+
+/**
+ * Skip past the ',' and to the next key and return true, or past the '}' at
+ * the end of the object and return false.
+ */
+json_force_inline bool skip_to_next_key(decode_context &context) {
+  skip_static_object_whitespace(context);
+  if (json_unlikely(peek(context) == '}')) {
+    context.position++;
+    return false;
+  }
+
+  skip_1(context, ',');
+  skip_static_object_whitespace(context);
+  return true;
+}
+
+template <typename T, size_t remaining_count, typename... fields_type>
+struct static_object_field final {
+  static constexpr size_t field_count = sizeof...(fields_type);
+  static constexpr size_t field_idx = field_count - remaining_count;
+  using field_type = typename std::tuple_element<field_idx, std::tuple<fields_type...>>::type;
+  using next_field = static_object_field<T, remaining_count - 1, fields_type...>;
+  using decode_function = size_t (*)(const std::tuple<fields_type...> &, decode_context &, T &, uint64_t &);
+
+  static constexpr uint64_t required_mask =
+      (field_type::is_required ? (uint64_t(1) << field_idx) : 0) | next_field::required_mask;
+
+  /**
+   * Decode the fields for as long as the keys in the input come in the order
+   * that the fields were given in, starting with this field. Each field goes
+   * straight on to the next one, so an object with its keys in order is
+   * decoded without looking anything up. Returns end_of_static_object at the
+   * end of the object, or, with the context still at the key, the index of
+   * this field if the input has some other key.
+   */
+  static size_t decode_in_order(
+      const std::tuple<fields_type...> &fields,
+      decode_context &context,
+      T &object,
+      uint64_t &seen) {
+    if (json_unlikely(!std::get<field_idx>(fields).skip_name(context))) {
+      return field_idx;
+    }
+
+    skip_key_separator(context);
+    return decode_value_in_order(fields, context, object, seen);
+  }
+
+  /**
+   * Like decode_in_order(...), for when the key of this field has already
+   * been decoded.
+   */
+  static size_t decode_value_in_order(
+      const std::tuple<fields_type...> &fields,
+      decode_context &context,
+      T &object,
+      uint64_t &seen) {
+    std::get<field_idx>(fields).decode(context, object);
+    seen |= (uint64_t(1) << field_idx);
+    if (json_unlikely(!skip_to_next_key(context))) {
+      return end_of_static_object;
+    }
+    return next_field::decode_in_order(fields, context, object, seen);
+  }
+
+  /**
+   * Set up what static_object_t needs to decode keys that are not in order:
+   * the decode functions of each field and a key_matcher with their names.
+   */
+  static void prepare(
+      const std::tuple<fields_type...> &fields,
+      decode_function *in_order_functions,
+      decode_function *value_functions,
+      key_matcher &matcher,
+      std::vector<size_t> &matched_fields) {
+    in_order_functions[field_idx] = &decode_in_order;
+    value_functions[field_idx] = &decode_value_in_order;
+    if (matcher.insert(std::get<field_idx>(fields).name())) {
+      matched_fields.push_back(size_t(field_idx));  // by value: field_idx has no definition
+    }
+    next_field::prepare(fields, in_order_functions, value_functions, matcher, matched_fields);
+  }
+
+  json_force_inline static void encode(
+      const std::tuple<fields_type...> &fields,
+      encode_context &context,
+      const T &object) {
+    std::get<field_idx>(fields).encode(context, object);
+    next_field::encode(fields, context, object);
+  }
+};
+
+template <typename T, typename... fields_type>
+struct static_object_field<T, 0, fields_type...> final {
+  using decode_function = size_t (*)(const std::tuple<fields_type...> &, decode_context &, T &, uint64_t &);
+
+  static constexpr uint64_t required_mask = 0;
+
+  static size_t decode_in_order(
+      const std::tuple<fields_type...> &fields,
+      decode_context &context,
+      T &object,
+      uint64_t &seen) {
+    return sizeof...(fields_type);
+  }
+
+  static void prepare(
+      const std::tuple<fields_type...> &fields,
+      decode_function *in_order_functions,
+      decode_function *value_functions,
+      key_matcher &matcher,
+      std::vector<size_t> &matched_fields) {
+    in_order_functions[sizeof...(fields_type)] = &decode_in_order;
+  }
+
+  json_force_inline static void encode(
+      const std::tuple<fields_type...> &fields,
+      encode_context &context,
+      const T &object) {}
+};
+
+}  // namespace detail
+
+namespace codec {
+
+/**
+ * An object codec where the set of fields is fixed at compile time. Unlike
+ * object_t, which keeps its fields behind virtual calls, the codec and member
+ * of each field are part of the type, so they are inlined into the decode and
+ * encode functions. When the keys come in the order that the fields were given
+ * in, which is the common case, each field is decoded by a function that goes
+ * straight on to the next field, with no index or table in between. Keys that
+ * come out of order are looked up in a key_matcher, like object_t does. This
+ * makes it a good fit for small, hot types.
+ *
+ * Fields have the same required and optional semantics as in object_t, but
+ * must be data members, and T must be default constructible. There can be at
+ * most 64 fields, and their names must be unique.
+ *
+ *   auto codec = codec::static_object<track_t>(
+ *       codec::required_field("id", &track_t::id),
+ *       codec::optional_field("uri", &track_t::uri));
+ */
+template <typename T, typename... fields_type>
+class static_object_t final {
+ public:
+  static_assert(
+      std::is_default_constructible<T>::value,
+      "The object type of a static_object_t must be default constructible");
+  static_assert(
+      sizeof...(fields_type) <= 64,
+      "A static_object_t can have at most 64 fields");
+
+  using object_type = T;
+
+  explicit static_object_t(fields_type... fields)
+      : _fields(std::move(fields)...) {
+    field_chain::prepare(_fields, _in_order_functions, _value_functions, _matcher, _matched_fields);
+  }
+
+  json_never_inline object_type decode(decode_context &context) const {
+    uint64_t seen = 0;
+    object_type output;
+
+    detail::skip_1(context, '{');
+    detail::skip_static_object_whitespace(context);
+    if (json_unlikely(detail::peek(context) == '}')) {
+      context.position++;
+    } else {
+      auto expected_idx = field_chain::decode_in_order(_fields, context, output, seen);
+      while (json_unlikely(expected_idx != detail::end_of_static_object)) {
+        expected_idx = decode_unexpected_key(context, output, seen, expected_idx);
+      }
+    }
+
+    const auto is_missing_req_fields = ((seen & field_chain::required_mask) != field_chain::required_mask);
+    detail::fail_if(context, is_missing_req_fields, "Missing required field(s)");
+    return output;
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    context.append('{');
+    field_chain::encode(_fields, context, value);
+    context.append_or_replace(',', '}');
+  }
+
+ private:
+  using field_chain = detail::static_object_field<T, sizeof...(fields_type), fields_type...>;
+  using decode_function = typename field_chain::decode_function;
+
+  /**
+   * Decode a key that is not the one of the field at expected_idx, and its
+   * value, and then go on in order from the field after it. The values of
+   * unknown keys are skipped, and the field at expected_idx is expected next.
+   */
+  json_never_inline size_t decode_unexpected_key(
+      decode_context &context,
+      object_type &output,
+      uint64_t &seen,
+      const size_t expected_idx) const {
+    const auto key_idx = decode_key(context);
+    detail::skip_key_separator(context);
+    if (json_likely(key_idx != detail::key_matcher::npos)) {
+      return _value_functions[_matched_fields[key_idx]](_fields, context, output, seen);
+    }
+
+    detail::skip_value(context);
+    if (!detail::skip_to_next_key(context)) {
+      return detail::end_of_static_object;
+    }
+    return _in_order_functions[expected_idx](_fields, context, output, seen);
+  }
+
+  /**
+   * Decode an object key and return its index in _matcher, or npos if it is
+   * not the name of a field. Keys without escape sequences are matched
+   * directly against the input.
+   */
+  json_force_inline size_t decode_key(decode_context &context) const {
+    detail::skip_1(context, '"');
+    const auto key_begin = context.position;
+    detail::skip_any_simple_characters(context);
+    if (json_likely(detail::next(context, "Unterminated string") == '"')) {
+      return _matcher.find(key_begin, context.position - 1);
+    }
+
+    context.position = key_begin - 1;
+    const auto key = string().decode(context);
+    return _matcher.find(key.data(), key.data() + key.size());
+  }
+
+  std::tuple<fields_type...> _fields;
+  decode_function _in_order_functions[sizeof...(fields_type) + 1];
+  decode_function _value_functions[sizeof...(fields_type) + 1];
+  detail::key_matcher _matcher;
+  std::vector<size_t> _matched_fields;  // The field of each key in _matcher
+};
+
+template <typename T, typename... fields_type>
+static_object_t<T, typename std::decay<fields_type>::type...> static_object(fields_type &&...fields) {
+  return static_object_t<T, typename std::decay<fields_type>::type...>(
+      std::forward<fields_type>(fields)...);
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <algorithm>
+#include <string>
 
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/decode_context.hpp>
@@ -31,29 +32,65 @@ namespace spotify {
 namespace json {
 namespace codec {
 
-class string_t final {
+/**
+ * A codec for std::string and other std::basic_string<char> types, such as
+ * arena_string.
+ */
+template <typename string_type>
+class basic_string_t final {
  public:
-  using object_type = std::string;
+  using object_type = string_type;
 
   json_never_inline object_type decode(decode_context &context) const {
     detail::skip_1(context, '"');
     return decode_string(context);
   }
 
+  /**
+   * Decode into an existing string, reusing its capacity.
+   */
+  json_never_inline void decode_into(decode_context &context, object_type &out) const {
+    detail::skip_1(context, '"');
+    const auto begin_simple = context.position;
+    detail::skip_any_simple_characters(context);
+    out.assign(begin_simple, context.position);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return;
+      case '\\': decode_escapes(context, out); return;
+      default: json_unreachable();
+    }
+  }
+
   json_never_inline void encode(encode_context &context, const object_type value) const {
+    encode_string(context, value.data(), value.size());
+  }
+
+  json_never_inline size_t encoded_size(const object_type &value) const {
+    return encoded_string_size(value.data(), value.size());
+  }
+
+  /**
+   * Write the given characters as a quoted and escaped JSON string. This is
+   * used by the other codecs that encode strings, such as string_ref_t.
+   */
+  static void encode_string(encode_context &context, const char *data, const size_t size) {
     context.append('"');
 
     // Write the strings in 1024 byte chunks, so that we do not have to reserve
-    // a potentially very large buffer for the escaped string. It is possible
-    // that the chunking will happen in the middle of a UTF-8 multi-byte
-    // character, but that is ok since write_escaped will not escape characters
-    // with the high bit set, so the combined escaped string will contain the
-    // correct UTF-8 characters in the end.
-    auto chunk_begin = value.data();
-    const auto string_end = chunk_begin + value.size();
+    // a potentially very large buffer for the escaped string. The chunks are
+    // moved back to not end in the middle of a UTF-8 multi-byte character, so
+    // that each chunk is valid UTF-8 on its own when validation is turned on.
+    // Without validation it would not matter, since write_escaped will not
+    // escape characters with the high bit set.
+    auto chunk_begin = data;
+    const auto string_end = chunk_begin + size;
 
     while (chunk_begin != string_end) {
-      const auto chunk_end = std::min(chunk_begin + 1024, string_end);
+      auto chunk_end = std::min(chunk_begin + 1024, string_end);
+      for (auto i = 0; i < 3 && chunk_end != string_end && is_continuation_byte(*chunk_end); i++) {
+        --chunk_end;
+      }
       detail::write_escaped(context, chunk_begin, chunk_end);
       chunk_begin = chunk_end;
     }
@@ -61,30 +98,46 @@ class string_t final {
     context.append('"');
   }
 
+  /**
+   * The number of bytes that encode_string(...) writes.
+   */
+  static size_t encoded_string_size(const char *data, const size_t size) {
+    return 2 + detail::escaped_size(data, data + size);
+  }
+
  private:
   json_force_inline static object_type decode_string(decode_context &context) {
     const auto begin_simple = context.position;
     detail::skip_any_simple_characters(context);
 
     switch (detail::next(context, "Unterminated string")) {
-      case '"': return std::string(begin_simple, context.position - 1);
+      case '"': return make_string(context, begin_simple, context.position - 1);
       case '\\': return decode_escaped_string(context, begin_simple);
       default: json_unreachable();
     }
   }
 
   json_never_inline static object_type decode_escaped_string(decode_context &context, const char *begin) {
-    std::string unescaped(begin, context.position - 1);
-    decode_escape(context, unescaped);
+    auto unescaped = make_string(context, begin, context.position - 1);
+    decode_escapes(context, unescaped);
+    return unescaped;
+  }
+
+  /**
+   * Append the rest of a string to 'out', starting with the escape sequence
+   * after the backslash at context.position - 1.
+   */
+  static void decode_escapes(decode_context &context, object_type &out) {
+    decode_escape(context, out);
 
     while (json_likely(context.remaining())) {
       const auto begin_simple = context.position;
       detail::skip_any_simple_characters(context);
-      unescaped.append(begin_simple, context.position);
+      out.append(begin_simple, context.position);
 
       switch (detail::next(context, "Unterminated string")) {
-        case '"': return unescaped;
-        case '\\': decode_escape(context, unescaped); break;
+        case '"': return;
+        case '\\': decode_escape(context, out); break;
         default: json_unreachable();
       }
     }
@@ -92,7 +145,13 @@ class string_t final {
     detail::fail(context, "Unterminated string");
   }
 
-  static void decode_escape(decode_context &context, std::string &out) {
+  json_force_inline static object_type make_string(decode_context &context, const char *begin, const char *end) {
+    auto string = detail::make_container<object_type>(context);
+    string.assign(begin, end);
+    return string;
+  }
+
+  static void decode_escape(decode_context &context, object_type &out) {
     const auto escape_character = detail::next(context, "Unterminated string");
     switch (escape_character) {
       case '"':  out.push_back('"');  break;
@@ -115,17 +174,44 @@ class string_t final {
     detail::fail(context, "\\u must be followed by 4 hex digits");
   }
 
-  static void decode_unicode_escape(decode_context &context, std::string &out) {
+  static unsigned decode_hex_quad(decode_context &context) {
     detail::require_bytes<4>(context, "\\u must be followed by 4 hex digits");
     const auto a = decode_hex_nibble(context, *(context.position++));
     const auto b = decode_hex_nibble(context, *(context.position++));
     const auto c = decode_hex_nibble(context, *(context.position++));
     const auto d = decode_hex_nibble(context, *(context.position++));
-    const auto p = unsigned((a << 12) | (b << 8) | (c << 4) | d);
-    encode_utf8(context, out, p);
+    return unsigned((a << 12) | (b << 8) | (c << 4) | d);
+  }
+
+  static void decode_unicode_escape(decode_context &context, object_type &out) {
+    const auto p = decode_hex_quad(context);
+    if (json_unlikely(context.validate_utf8 && (p & 0xF800) == 0xD800)) {
+      decode_surrogate_pair(context, out, p);
+    } else {
+      encode_utf8(context, out, p);
+    }
   }
 
-  static void encode_utf8(decode_context &context, std::string &out, unsigned p) {
+  /**
+   * Surrogates are not valid in UTF-8, so when validating, a pair of them such
+   * as "\ud83d\ude00" is decoded into the 4-byte sequence for the code point
+   * that the pair stands for, and a surrogate that is not part of a pair fails.
+   */
+  static void decode_surrogate_pair(decode_context &context, object_type &out, unsigned high) {
+    detail::fail_if(context, high >= 0xDC00, "Unpaired UTF-16 surrogate in \\u escape", -6);
+    detail::fail_if(context,
+        context.remaining() < 2 ||
+        context.position[0] != '\\' ||
+        context.position[1] != 'u',
+        "Unpaired UTF-16 surrogate in \\u escape",
+        -6);
+    context.position += 2;
+    const auto low = decode_hex_quad(context);
+    detail::fail_if(context, (low & 0xFC00) != 0xDC00, "Unpaired UTF-16 surrogate in \\u escape", -6);
+    encode_utf8_4(out, 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00));
+  }
+
+  static void encode_utf8(decode_context &context, object_type &out, unsigned p) {
     if (json_likely(p <= 0x7F)) {
       encode_utf8_1(out, p);
     } else if (json_likely(p <= 0x07FF)) {
@@ -135,37 +221,54 @@ class string_t final {
     }
   }
 
-  static void encode_utf8_1(std::string &out, unsigned p) {
+  static void encode_utf8_1(object_type &out, unsigned p) {
     const char c0 = (p & 0x7F);
     out.push_back(c0);
   }
 
-  static void encode_utf8_2(std::string &out, unsigned p) {
+  static void encode_utf8_2(object_type &out, unsigned p) {
     const char c0 = 0xC0 | ((p >> 6) & 0x1F);
     const char c1 = 0x80 | ((p >> 0) & 0x3F);
     const char cc[] = { c0, c1 };
     out.append(&cc[0], 2);
   }
 
-  static void encode_utf8_3(std::string &out, unsigned p) {
+  static void encode_utf8_3(object_type &out, unsigned p) {
     const char c0 = 0xE0 | ((p >> 12) & 0x0F);
     const char c1 = 0x80 | ((p >>  6) & 0x3F);
     const char c2 = 0x80 | ((p >>  0) & 0x3F);
     const char cc[] = { c0, c1, c2 };
     out.append(&cc[0], 3);
   }
+
+  static void encode_utf8_4(object_type &out, unsigned p) {
+    const char c0 = 0xF0 | ((p >> 18) & 0x07);
+    const char c1 = 0x80 | ((p >> 12) & 0x3F);
+    const char c2 = 0x80 | ((p >>  6) & 0x3F);
+    const char c3 = 0x80 | ((p >>  0) & 0x3F);
+    const char cc[] = { c0, c1, c2, c3 };
+    out.append(&cc[0], 4);
+  }
+
+  json_force_inline static bool is_continuation_byte(const char c) {
+    return ((static_cast<uint8_t>(c) & 0xC0) == 0x80);
+  }
 };
 
+using string_t = basic_string_t<std::string>;
+
 inline string_t string() {
   return string_t();
 }
 
 }  // namespace codec
 
-template <>
-struct default_codec_t<std::string> {
-  static codec::string_t codec() {
-    return codec::string_t();
+template <typename allocator_type>
+struct default_codec_t<std::basic_string<char, std::char_traits<char>, allocator_type>> {
+  using string_type = std::basic_string<char, std::char_traits<char>, allocator_type>;
+
+  static codec::basic_string_t<string_type> codec() {
+    return codec::basic_string_t<string_type>();
   }
 };
 
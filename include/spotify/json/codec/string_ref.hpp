@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/string_ref.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * A codec for strings that does not copy the decoded characters, unless they
+ * contain escape sequences. The decoded string_ref points into the input, so
+ * the input must outlive it.
+ */
+class string_ref_t final {
+ public:
+  using object_type = json::string_ref;
+
+  json_never_inline object_type decode(decode_context &context) const {
+    detail::skip_1(context, '"');
+    const auto begin_simple = context.position;
+    detail::skip_any_simple_characters(context);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return object_type(begin_simple, context.position - begin_simple - 1);
+      case '\\': return decode_escaped_string(context, begin_simple);
+      default: json_unreachable();
+    }
+  }
+
+  json_never_inline void encode(encode_context &context, const object_type &value) const {
+    string_t::encode_string(context, value.data(), value.size());
+  }
+
+  json_never_inline size_t encoded_size(const object_type &value) const {
+    return string_t::encoded_string_size(value.data(), value.size());
+  }
+
+ private:
+  json_never_inline static object_type decode_escaped_string(decode_context &context, const char *begin) {
+    context.position = begin - 1;  // rewind to the '"', string_t does the unescaping
+    return object_type::owning(string_t().decode(context));
+  }
+};
+
+inline string_ref_t string_ref() {
+  return string_ref_t();
+}
+
+}  // namespace codec
+
+template <>
+struct default_codec_t<string_ref> {
+  static codec::string_ref_t codec() {
+    return codec::string_ref_t();
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -55,12 +55,22 @@ struct tuple_field final {
     }
     tuple_field<T, remaining_count - 1, codecs_type...>::encode(codecs, context, object);
   }
+
+  static size_t encoded_size(const std::tuple<codecs_type...> &codecs, const T &object) {
+    const auto &codec = std::get<element_idx>(codecs);
+    const auto &element = std::get<element_idx>(object);
+    const auto size = (json_likely(detail::should_encode(codec, element)) ?
+        detail::encoded_size(codec, element) + 1 :
+        0);
+    return size + tuple_field<T, remaining_count - 1, codecs_type...>::encoded_size(codecs, object);
+  }
 };
 
 template <typename T, typename... codecs_type>
 struct tuple_field<T, 0, codecs_type...> {
   static void decode(const std::tuple<codecs_type...> &codecs, decode_context &, T &) {}
   static void encode(const std::tuple<codecs_type...> &codecs, encode_context &, const T &) {}
+  static size_t encoded_size(const std::tuple<codecs_type...> &codecs, const T &) { return 0; }
 };
 
 }
@@ -93,6 +103,12 @@ class tuple_t final {
     context.append_or_replace(',', ']');
   }
 
+  size_t encoded_size(const object_type &object) const {
+    const auto size = detail::tuple_field<object_type, element_count, codecs_type...>::encoded_size(
+        _codecs, object);
+    return (size ? size + 1 : 2);  // '[', and the last ',' is replaced by ']'
+  }
+
  private:
   std::tuple<codecs_type ...> _codecs;
 };
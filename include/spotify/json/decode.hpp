@@ -18,10 +18,12 @@
 
 #include <cstring>
 
+#include <spotify/json/arena.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/structural_index.hpp>
 
 namespace spotify {
 namespace json {
@@ -50,6 +52,45 @@ typename codec_type::object_type decode(const codec_type &codec, const string_ty
   return decode(codec, string.data(), string.size());
 }
 
+/**
+ * Decode with an arena, so that containers with an arena_allocator, such as
+ * arena_string and arena_vector, allocate their memory from it. The arena must
+ * outlive the decoded object. See arena.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode(const codec_type &codec, const char *data, size_t size, arena &arena) {
+  decode_context c(data, data + size, &arena);
+  detail::skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode(const codec_type &codec, const char *cstr, arena &arena) {
+  return decode(codec, cstr, cstr ? std::strlen(cstr) : 0, arena);
+}
+
+template <typename codec_type, typename string_type>
+typename codec_type::object_type decode(const codec_type &codec, const string_type &string, arena &arena) {
+  return decode(codec, string.data(), string.size(), arena);
+}
+
+/**
+ * Decode the document that the index was built for, using the index to skip
+ * whitespace and unknown objects and arrays. See structural_index.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode(const codec_type &codec, structural_index &index) {
+  decode_context c(index);
+  detail::skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
 /*
  * json::decode(data...)
  */
@@ -69,6 +110,66 @@ value_type decode(const string_type &string) {
   return decode(default_codec<value_type>(), string);
 }
 
+/*
+ * json::decode_into(codec, data..., &object)
+ */
+
+/**
+ * Decode into an existing object instead of returning a new one, so that a
+ * hot loop can decode many documents into the same object and reuse the memory
+ * of its strings and containers. See the documentation of decode_into in the
+ * codecs for what is reused; codecs that cannot decode in place assign to the
+ * object instead. If decoding fails, the object is left in a valid but
+ * unspecified state.
+ */
+template <typename codec_type>
+void decode_into(
+    const codec_type &codec,
+    const char *data,
+    size_t size,
+    typename codec_type::object_type &object) {
+  decode_context c(data, data + size);
+  detail::skip_any_whitespace(c);
+  detail::decode_into(codec, c, object);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+}
+
+template <typename codec_type>
+void decode_into(
+    const codec_type &codec,
+    const char *cstr,
+    typename codec_type::object_type &object) {
+  decode_into(codec, cstr, cstr ? std::strlen(cstr) : 0, object);
+}
+
+template <typename codec_type, typename string_type>
+void decode_into(
+    const codec_type &codec,
+    const string_type &string,
+    typename codec_type::object_type &object) {
+  decode_into(codec, string.data(), string.size(), object);
+}
+
+/*
+ * json::decode_into(data..., &object)
+ */
+
+template <typename value_type>
+void decode_into(const char *data, size_t size, value_type &object) {
+  decode_into(default_codec<value_type>(), data, size, object);
+}
+
+template <typename value_type>
+void decode_into(const char *cstr, value_type &object) {
+  decode_into(default_codec<value_type>(), cstr, object);
+}
+
+template <typename value_type, typename string_type>
+void decode_into(const string_type &string, value_type &object) {
+  decode_into(default_codec<value_type>(), string, object);
+}
+
 /*
  * json::try_decode(&object, codec, data...)
  */
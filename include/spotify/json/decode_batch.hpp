@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/batch.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * How the records in a batch are separated.
+ */
+enum class batch_format {
+  /** One record per line, i.e., JSON Lines or NDJSON. */
+  lines,
+
+  /** Values that follow each other, optionally separated by whitespace. */
+  concatenated
+};
+
+/**
+ * The values that were decoded from a batch, in the order of the records, and
+ * the errors for the records that could not be decoded. The values of those
+ * records are default constructed.
+ */
+template <typename T>
+struct batch_result {
+  std::vector<T> values;
+  std::vector<batch_error> errors;  // ordered by index
+
+  bool ok() const {
+    return errors.empty();
+  }
+};
+
+/**
+ * Decode a batch of records with the codec, on up to 'threads' threads (by
+ * default, one per core). The records are decoded independently of each
+ * other, so an invalid record only fails itself. The object type of the codec
+ * must be default constructible. The codec must be safe to use from several
+ * threads at once, which all of the codecs in this library are. Batches of
+ * bool values are not supported; wrap them in a struct or decode them as int.
+ */
+template <typename codec_type>
+batch_result<typename codec_type::object_type> decode_batch(
+    const codec_type &codec,
+    const char *data,
+    size_t size,
+    const batch_format format = batch_format::lines,
+    const unsigned threads = std::thread::hardware_concurrency()) {
+  static_assert(
+      detail::is_batch_value<typename codec_type::object_type>::value,
+      "decode_batch can not decode bool values, since the threads would share "
+      "the words of std::vector<bool>; wrap them in a struct instead");
+  batch_result<typename codec_type::object_type> result;
+  const auto records = (format == batch_format::lines ?
+      detail::split_lines(data, size) :
+      detail::split_concatenated(data, size, result.errors));
+
+  result.values.resize(records.size());
+  std::mutex errors_mutex;
+  detail::parallel_for(records.size(), threads, [&](const size_t begin, const size_t end) {
+    std::vector<batch_error> errors;
+    for (auto i = begin; i < end; i++) {
+      const auto &record = records[i];
+      try {
+        decode_into(codec, record.data, record.size, result.values[i]);
+      } catch (const decode_exception &exception) {
+        result.values[i] = typename codec_type::object_type();
+        errors.push_back(batch_error{ i, record.offset + exception.offset(), exception.what() });
+      }
+    }
+
+    if (!errors.empty()) {
+      std::lock_guard<std::mutex> lock(errors_mutex);
+      result.errors.insert(result.errors.end(), errors.begin(), errors.end());
+    }
+  });
+
+  std::sort(result.errors.begin(), result.errors.end(), [](const batch_error &a, const batch_error &b) {
+    return (a.index < b.index);
+  });
+  return result;
+}
+
+template <typename codec_type, typename string_type>
+batch_result<typename codec_type::object_type> decode_batch(
+    const codec_type &codec,
+    const string_type &string,
+    const batch_format format = batch_format::lines,
+    const unsigned threads = std::thread::hardware_concurrency()) {
+  return decode_batch(codec, string.data(), string.size(), format, threads);
+}
+
+template <typename value_type, typename string_type>
+batch_result<value_type> decode_batch(
+    const string_type &string,
+    const batch_format format = batch_format::lines,
+    const unsigned threads = std::thread::hardware_concurrency()) {
+  return decode_batch(default_codec<value_type>(), string.data(), string.size(), format, threads);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -19,29 +19,56 @@
 #include <cstddef>
 
 #include <spotify/json/decode_exception.hpp>
-#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/structural_index.hpp>
 
 namespace spotify {
 namespace json {
 
+class arena;
+
 /**
  * A decode_context has the information that is kept while decoding JSON with
  * codecs. It has information about the data to read and whether the decoding
  * has failed.
+ *
+ * A decode_context that is constructed from a structural_index uses the index
+ * to skip whitespace and unknown objects and arrays, see structural_index.
+ *
+ * A decode_context with an arena makes the codecs that decode into containers
+ * with an arena_allocator allocate their memory from it, see arena.
+ *
+ * Strings are not checked for valid UTF-8 by default. Set validate_utf8 to make
+ * decoding fail on invalid UTF-8 in any string, including the keys and the
+ * values that are skipped. This is done while the strings are scanned, so it is
+ * a lot cheaper than validating the input in a separate pass.
+ *
+ * Set skip_unchecked to skip the objects and arrays that are not decoded, such
+ * as the values of unknown fields, by only finding their closing bracket with
+ * SIMD instead of checking that they are valid JSON. This should only be used
+ * for trusted input. It has no effect when validate_utf8 is set.
  */
 struct decode_context final {
-  decode_context(const char *begin, const char *end)
-      : has_sse42(detail::cpuid().has_sse42()),
-        position(begin),
+  decode_context(const char *begin, const char *end, json::arena *arena = nullptr)
+      : position(begin),
         begin(begin),
-        end(end) {}
+        end(end),
+        index(nullptr),
+        arena(arena) {}
 
-  decode_context(const char *data, size_t size)
-      : has_sse42(detail::cpuid().has_sse42()),
-        position(data),
+  decode_context(const char *data, size_t size, json::arena *arena = nullptr)
+      : position(data),
         begin(data),
-        end(data + size) {}
+        end(data + size),
+        index(nullptr),
+        arena(arena) {}
+
+  explicit decode_context(structural_index &index, json::arena *arena = nullptr)
+      : position(index.begin()),
+        begin(index.begin()),
+        end(index.end()),
+        index(index.valid() ? &index : nullptr),
+        arena(arena) {}
 
   json_force_inline size_t offset() const {
     return (position - begin);
@@ -55,10 +82,13 @@ struct decode_context final {
     return (end - position);
   }
 
-  const bool has_sse42;
   const char *position;
   const char *const begin;
   const char *const end;
+  structural_index *const index;
+  json::arena *const arena;
+  bool validate_utf8 = false;
+  bool skip_unchecked = false;
 };
 
 }  // namespace json
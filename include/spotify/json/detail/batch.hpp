@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Why a record in a batch could not be decoded. See decode_batch.
+ */
+struct batch_error {
+  /** The index of the record in the batch. */
+  size_t index;
+
+  /** The offset of the error from the start of the batch. */
+  size_t offset;
+
+  std::string message;
+};
+
+namespace detail {
+
+/**
+ * Whether values of type T can be decoded in a batch. The threads store their
+ * values directly in a std::vector<T>, which is only safe when each element is
+ * a separate object. That is not the case for std::vector<bool>, which packs
+ * the values into shared words.
+ */
+template <typename T>
+struct is_batch_value : std::integral_constant<bool, !std::is_same<T, bool>::value> {};
+
+struct batch_record {
+  const char *data;
+  size_t size;
+  size_t offset;
+};
+
+/**
+ * Split a buffer of JSON Lines into records, one per line. Lines that are
+ * empty or only have whitespace are not records. Newlines can not occur inside
+ * JSON strings, so a broken record never affects the records after it.
+ */
+std::vector<batch_record> split_lines(const char *data, size_t size);
+
+/**
+ * Split a buffer of concatenated JSON values, which may be separated by
+ * whitespace, into records. If the buffer can not be split, because it has a
+ * value that is not terminated or a stray bracket, the error is added to
+ * 'errors' with the index of the record that would have come next, and the
+ * records before it are returned.
+ */
+std::vector<batch_record> split_concatenated(
+    const char *data,
+    size_t size,
+    std::vector<batch_error> &errors);
+
+/**
+ * Call body(begin, end) for ranges of [0, size) on up to 'threads' threads,
+ * one of which is the calling thread. The other threads are taken from a pool
+ * that is kept between calls. The ranges are small and are handed out one at
+ * a time, so a few slow records do not hold up the others. If body throws, the
+ * first exception is rethrown once all threads are done.
+ */
+void parallel_for(
+    size_t size,
+    unsigned threads,
+    const std::function<void (size_t begin, size_t end)> &body);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
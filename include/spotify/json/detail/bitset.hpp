@@ -37,6 +37,12 @@ struct bitset {
     }
   }
 
+  json_force_inline bool test(const std::size_t index) const {
+    const auto byte = (index / 8);
+    const auto mask = (1 << (index & 7));
+    return ((json_likely(!_vector) ? _array[byte] : (*_vector)[byte]) & mask) != 0;
+  }
+
   json_force_inline uint8_t test_and_set(const std::size_t index) {
     const auto byte = (index / 8);
     const auto bidx = (index & 7);
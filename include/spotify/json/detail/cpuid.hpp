@@ -29,31 +29,66 @@ namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * Probes the features of the CPU that the process is running on. Executing the
+ * cpuid instruction is expensive (it is serializing, and traps to the host when
+ * running under most hypervisors), so a cpuid object should not be constructed
+ * on any hot path. Use simd() in simd_dispatch.hpp instead, which probes the CPU
+ * once per process.
+ */
 class cpuid {
  public:
   cpuid() {
+    _registers_1.fill(0);
+    _registers_7.fill(0);
 #if defined(json_arch_x86)
-    const uint32_t cpuid_function(1);
-#if defined(_MSC_VER)
-    ::__cpuid(reinterpret_cast<int *>(_registers.data()), cpuid_function);
-#elif defined(__GNUC__)
-    __asm__ __volatile__ (
-        "cpuid ;\n"
-        : "=a" (_registers[cpu_register::eax]),
-          "=b" (_registers[cpu_register::ebx]),
-          "=c" (_registers[cpu_register::ecx]),
-          "=d" (_registers[cpu_register::edx])
-        : "a" (cpuid_function)
-        :);
-#endif  // defined(_MSC_VER)
+    read_registers(0, _registers_1);
+    const auto max_function = _registers_1[cpu_register::eax];
+    read_registers(1, _registers_1);
+    if (max_function >= 7) {
+      read_registers(7, _registers_7);
+    }
+
+    // The AVX register state must be enabled by the operating system before
+    // any AVX instructions can be used, which is reported through XCR0.
+    if (has_feature_bit(_registers_1, cpu_register::ecx, cpu_feature_bit::osxsave)) {
+      _xcr0 = read_xcr0();
+    }
 #endif  // defined(json_arch_x86)
   }
 
+  bool has_sse2() const {
+    return has_feature_bit(_registers_1, cpu_register::edx, cpu_feature_bit::sse_2);
+  }
+
   bool has_sse42() const {
-    return has_feature_bit(cpu_register::ecx, cpu_feature_bit::sse_42);
+    return has_feature_bit(_registers_1, cpu_register::ecx, cpu_feature_bit::sse_42);
+  }
+
+  bool has_avx2() const {
+    return
+        has_os_support(xcr0_bit::ymm_state) &&
+        has_feature_bit(_registers_7, cpu_register::ebx, cpu_feature_bit::avx2);
+  }
+
+  bool has_avx512bw() const {
+    return
+        has_os_support(xcr0_bit::zmm_state) &&
+        has_feature_bit(_registers_7, cpu_register::ebx, cpu_feature_bit::avx512f) &&
+        has_feature_bit(_registers_7, cpu_register::ebx, cpu_feature_bit::avx512bw);
+  }
+
+  bool has_neon() const {
+#if defined(json_arch_arm64)
+    return true;  // Advanced SIMD is a mandatory part of AArch64
+#else
+    return false;
+#endif  // defined(json_arch_arm64)
   }
 
  private:
+  using registers = std::array<uint32_t, 4>;
+
   struct cpu_register {
     enum type {
       eax = 0,
@@ -65,17 +100,69 @@ class cpuid {
 
   struct cpu_feature_bit {
     enum type {
-      sse_42 = 20,
+      sse_2 = 26,     // function 1, edx
+      sse_42 = 20,    // function 1, ecx
+      osxsave = 27,   // function 1, ecx
+      avx2 = 5,       // function 7, ebx
+      avx512f = 16,   // function 7, ebx
+      avx512bw = 30,  // function 7, ebx
+    };
+  };
+
+  struct xcr0_bit {
+    enum type {
+      ymm_state = 0x06,  // SSE and AVX state
+      zmm_state = 0xE6,  // SSE, AVX, opmask and ZMM state
     };
   };
 
-  bool has_feature_bit(
+#if defined(json_arch_x86)
+  static void read_registers(const uint32_t cpuid_function, registers &regs) {
+#if defined(_MSC_VER)
+    ::__cpuidex(reinterpret_cast<int *>(regs.data()), cpuid_function, 0);
+#elif defined(__GNUC__)
+    __asm__ __volatile__ (
+        "cpuid ;\n"
+        : "=a" (regs[cpu_register::eax]),
+          "=b" (regs[cpu_register::ebx]),
+          "=c" (regs[cpu_register::ecx]),
+          "=d" (regs[cpu_register::edx])
+        : "a" (cpuid_function), "c" (0)
+        :);
+#endif  // defined(_MSC_VER)
+  }
+
+  static uint64_t read_xcr0() {
+#if defined(_MSC_VER)
+    return ::_xgetbv(0);
+#elif defined(__GNUC__)
+    uint32_t eax, edx;
+    __asm__ __volatile__ (
+        "xgetbv ;\n"
+        : "=a" (eax), "=d" (edx)
+        : "c" (0)
+        :);
+    return (uint64_t(edx) << 32) | eax;
+#else
+    return 0;
+#endif  // defined(_MSC_VER)
+  }
+#endif  // defined(json_arch_x86)
+
+  static bool has_feature_bit(
+      const registers &regs,
       const cpu_register::type &reg,
-      const cpu_feature_bit::type &bit) const {
-    return (_registers[reg] & (1 << bit)) != 0;
+      const cpu_feature_bit::type &bit) {
+    return (regs[reg] & (1U << bit)) != 0;
+  }
+
+  bool has_os_support(const xcr0_bit::type &bits) const {
+    return (_xcr0 & bits) == bits;
   }
 
-  std::array<uint32_t, 4> _registers;
+  registers _registers_1;
+  registers _registers_7;
+  uint64_t _xcr0 = 0;
 };
 
 }  // namespace detail
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Try to decode the JSON number at the start of [begin, end) into the nearest
+ * float or double, without going through double-conversion. Numbers with at
+ * most 19 significant digits are converted exactly, using plain floating point
+ * arithmetic when both the digits and the power of ten are exactly
+ * representable, and using the Eisel-Lemire algorithm otherwise.
+ *
+ * On success, 'number_end' is set to the first character after the number and
+ * true is returned. False is returned, and the outputs are left untouched, when
+ * the number is not plain JSON (e.g., it has a leading '+' or a missing digit),
+ * when the exponent is out of range, or when the correctly rounded result could
+ * not be proven. The caller must then use a slower, general routine.
+ */
+bool decode_float_fast(const char *begin, const char *end, float &value, const char *&number_end);
+bool decode_float_fast(const char *begin, const char *end, double &value, const char *&number_end);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -20,9 +20,12 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <spotify/json/arena.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
@@ -131,6 +134,18 @@ json_force_inline void skip_4(decode_context &context, const char characters[4])
   context.position += 4;
 }
 
+/**
+ * Skip past the whitespace between two tokens. If the context has a structural
+ * index, the next token is looked up in the index instead of scanning for it.
+ */
+json_force_inline void skip_whitespace_between_tokens(decode_context &context) {
+  if (context.index) {
+    context.position = context.index->skip_whitespace(context.position);
+  } else {
+    skip_any_whitespace(context);
+  }
+}
+
 /**
  * Helper function for parsing the comma separated entities in JSON: objects
  * and arrays. intro and outro are the characters before and after the entity:
@@ -146,17 +161,17 @@ json_force_inline void skip_4(decode_context &context, const char characters[4])
 template <typename parse_function>
 json_never_inline void decode_comma_separated(decode_context &context, char intro, char outro, parse_function parse) {
   skip_1(context, intro);
-  skip_any_whitespace(context);
+  skip_whitespace_between_tokens(context);
 
   if (json_likely(peek(context) != outro)) {
     parse();
-    skip_any_whitespace(context);
+    skip_whitespace_between_tokens(context);
 
     while (json_likely(peek(context) != outro)) {
       skip_1(context, ',');
-      skip_any_whitespace(context);
+      skip_whitespace_between_tokens(context);
       parse();
-      skip_any_whitespace(context);
+      skip_whitespace_between_tokens(context);
     }
   }
 
@@ -174,13 +189,126 @@ json_force_inline void decode_object(decode_context &context, const callback_fun
   auto codec = key_codec_type();
   decode_comma_separated(context, '{', '}', [&]{
     auto key = codec.decode(context);
-    skip_any_whitespace(context);
+    skip_whitespace_between_tokens(context);
     skip_1(context, ':');
-    skip_any_whitespace(context);
+    skip_whitespace_between_tokens(context);
     callback(std::move(key));
   });
 }
 
+template <typename T, typename = void>
+struct container_factory {
+  static T make(decode_context &) {
+    return T();
+  }
+};
+
+template <typename T>
+struct container_factory<T, typename std::enable_if<std::is_same<
+    typename T::allocator_type,
+    arena_allocator<typename T::allocator_type::value_type>>::value>::type> {
+  static T make(decode_context &context) {
+    return T(typename T::allocator_type(context.arena));
+  }
+};
+
+/**
+ * Create an empty container of the given type. Containers with an
+ * arena_allocator get their memory from the arena of the context, if any.
+ */
+template <typename T>
+json_force_inline T make_container(decode_context &context) {
+  return container_factory<T>::make(context);
+}
+
+template <typename T>
+struct has_decode_into_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<const U>().decode_into(
+          std::declval<decode_context &>(),
+          std::declval<typename U::object_type &>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Decode into an existing value. Codecs that can do so reuse the memory that
+ * the value already has, e.g., the capacity of strings and vectors; for other
+ * codecs, the value is assigned the result of decode(...).
+ */
+template <typename codec_type>
+typename std::enable_if<!has_decode_into_method<codec_type>::value, void>::type
+json_force_inline decode_into(
+    const codec_type &codec,
+    decode_context &context,
+    typename codec_type::object_type &value) {
+  value = codec.decode(context);
+}
+
+template <typename codec_type>
+typename std::enable_if<has_decode_into_method<codec_type>::value, void>::type
+json_force_inline decode_into(
+    const codec_type &codec,
+    decode_context &context,
+    typename codec_type::object_type &value) {
+  codec.decode_into(context, value);
+}
+
+/**
+ * Decode into a container element or object member of a type that may differ
+ * from the codec's object type. It is decoded in place when the types are the
+ * same, and by assignment otherwise (e.g., for std::vector<bool> proxies).
+ */
+template <typename codec_type, typename element_type>
+typename std::enable_if<
+    std::is_same<element_type, typename codec_type::object_type>::value, void>::type
+json_force_inline decode_element(
+    const codec_type &codec,
+    decode_context &context,
+    element_type &element) {
+  decode_into(codec, context, element);
+}
+
+template <typename codec_type, typename element_type>
+typename std::enable_if<
+    !std::is_same<typename std::decay<element_type>::type, typename codec_type::object_type>::value, void>::type
+json_force_inline decode_element(
+    const codec_type &codec,
+    decode_context &context,
+    element_type &&element) {
+  element = codec.decode(context);
+}
+
+/**
+ * Set an element to its default value. Containers and strings whose default
+ * value is empty are cleared, so that they keep their capacity.
+ */
+template <typename element_type>
+json_force_inline auto reset_element(element_type &element, element_type &&default_value, int)
+    -> decltype(element.clear(), default_value.empty(), void()) {
+  if (default_value.empty()) {
+    element.clear();
+  } else {
+    element = std::move(default_value);
+  }
+}
+
+template <typename element_type>
+json_force_inline void reset_element(element_type &element, element_type &&default_value, long) {
+  element = std::move(default_value);
+}
+
+template <typename element_type>
+json_force_inline void reset_element(element_type &element, element_type &&default_value) {
+  reset_element(element, std::move(default_value), 0);
+}
+
 json_force_inline void skip_true(decode_context &context) {
   skip_4(context, "true");
 }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Lends out an encode_context that is kept per thread, so that encode(...)
+ * does not have to allocate a new buffer on each call. The context is empty
+ * when it is lent out. If the thread's context is already in use, e.g.,
+ * because a codec calls encode(...) while encoding, a new context is made.
+ * A context that has grown very large is freed when it is returned, so that
+ * encoding one large value does not keep its memory around for good.
+ */
+class pooled_encode_context final {
+ public:
+  pooled_encode_context();
+  ~pooled_encode_context();
+
+  pooled_encode_context(const pooled_encode_context &) = delete;
+  pooled_encode_context &operator=(const pooled_encode_context &) = delete;
+
+  json_force_inline encode_context &operator*() const { return *_context; }
+
+ private:
+  encode_context *_context;
+  std::unique_ptr<encode_context> _owned;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Encode the shortest decimal number that decodes back to the given (finite)
+ * value, using the Schubfach algorithm. The number is written in the same form
+ * as ECMAScript's Number.prototype.toString(), e.g., '0.25', '1e+21', '1.5e-7',
+ * except that negative zero is written as '0'.
+ */
+void encode_double_shortest(encode_context &context, double value);
+
+/**
+ * Encode the given (finite) value rounded to at most 'significant_digits'
+ * significant digits, which must be at least 1. The number is written in the
+ * same form as by encode_double_shortest(...), without trailing zeros, so 0.5
+ * is written as '0.5' for any precision. If the value can be written with fewer
+ * digits than requested without changing it, the shortest form is used.
+ */
+void encode_double_precision(encode_context &context, double value, unsigned significant_digits);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -16,14 +16,25 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_exception.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/encode_sink.hpp>
 
 namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * The largest number of bytes that the codecs in this library reserve in an
+ * encode_context at once, which they do when escaping a 1024 byte chunk of a
+ * string. Appending data that is already encoded, such as an encoded_value,
+ * reserves exactly its size, but does not reserve more than it writes.
+ */
+constexpr size_t max_encode_reservation = 6 * 1024;
+
 template <typename string_type>
 json_never_inline json_noreturn void fail(
     const encode_context &context,
@@ -67,6 +78,58 @@ json_force_inline should_encode(const codec_type &codec, const typename codec_ty
   return codec.should_encode(value);
 }
 
+template <typename T>
+struct has_encoded_size_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<U>().encoded_size(std::declval<typename U::object_type>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Only counts the bytes that are written to it.
+ */
+class counting_sink final : public encode_sink {
+ public:
+  void write(const char *, size_t size) override {
+    _size += size;
+  }
+
+  json_force_inline size_t size() const { return _size; }
+
+ private:
+  size_t _size = 0;
+};
+
+/**
+ * The number of bytes that codec.encode(...) writes for 'value'. Codecs that
+ * do not have an encoded_size(...) method are measured by encoding the value
+ * through a buffer on the stack into a counting_sink, which does not allocate
+ * unless a single reservation is larger than the buffer.
+ */
+template <typename codec_type>
+typename std::enable_if<!has_encoded_size_method<codec_type>::value, size_t>::type
+json_never_inline encoded_size(const codec_type &codec, const typename codec_type::object_type &value) {
+  char buffer[2 * max_encode_reservation];
+  counting_sink sink;
+  encode_context context(sink, buffer, sizeof(buffer));
+  codec.encode(context, value);
+  context.flush();
+  return sink.size();
+}
+
+template <typename codec_type>
+typename std::enable_if<has_encoded_size_method<codec_type>::value, size_t>::type
+json_force_inline encoded_size(const codec_type &codec, const typename codec_type::object_type &value) {
+  return codec.encoded_size(value);
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <spotify/json/detail/macros.hpp>
@@ -30,6 +31,11 @@ void encode_negative_integer_64(encode_context &context, int64_t value);
 void encode_positive_integer_32(encode_context &context, uint32_t value);
 void encode_positive_integer_64(encode_context &context, uint64_t value);
 
+/**
+ * The number of decimal digits in 'value'.
+ */
+unsigned count_integer_digits(uint64_t value);
+
 template <typename T>
 json_force_inline void encode_negative_integer(encode_context &context, T value) {
   return (sizeof(T) <= sizeof(int32_t)) ?
@@ -44,6 +50,22 @@ json_force_inline void encode_positive_integer(encode_context &context, T value)
     encode_positive_integer_64(context, static_cast<uint64_t>(value));
 }
 
+/**
+ * The number of bytes that encode_negative_integer(...) writes for 'value'.
+ */
+template <typename T>
+json_force_inline size_t encoded_negative_integer_size(T value) {
+  return 1 + count_integer_digits(0 - static_cast<uint64_t>(value));
+}
+
+/**
+ * The number of bytes that encode_positive_integer(...) writes for 'value'.
+ */
+template <typename T>
+json_force_inline size_t encoded_positive_integer_size(T value) {
+  return count_integer_digits(static_cast<uint64_t>(value));
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
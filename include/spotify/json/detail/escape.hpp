@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <spotify/json/encode_context.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/simd_dispatch.hpp>
 
 namespace spotify {
 namespace json {
@@ -33,8 +36,46 @@ void write_escaped_sse42(
     encode_context &context,
     const char *begin,
     const char *end);
+
+void write_escaped_avx2(
+    encode_context &context,
+    const char *begin,
+    const char *end);
 #endif  // defined(json_arch_x86)
 
+#if defined(json_simd_avx512)
+void write_escaped_avx512(
+    encode_context &context,
+    const char *begin,
+    const char *end);
+#endif  // defined(json_simd_avx512)
+
+#if defined(json_arch_arm64)
+void write_escaped_neon(
+    encode_context &context,
+    const char *begin,
+    const char *end);
+#endif  // defined(json_arch_arm64)
+
+void write_escaped_utf8_scalar(
+    encode_context &context,
+    const char *begin,
+    const char *end);
+
+#if defined(json_arch_x86)
+void write_escaped_utf8_avx2(
+    encode_context &context,
+    const char *begin,
+    const char *end);
+#endif  // defined(json_arch_x86)
+
+#if defined(json_simd_avx512)
+void write_escaped_utf8_avx512(
+    encode_context &context,
+    const char *begin,
+    const char *end);
+#endif  // defined(json_simd_avx512)
+
 /**
  * \brief Escape a string for use in a JSON string as per RFC 4627.
  *
@@ -42,19 +83,27 @@ void write_escaped_sse42(
  * backslashes and quotation marks.
  *
  * See: http://www.ietf.org/rfc/rfc4627.txt (Section 2.5)
+ *
+ * If context.validate_utf8() is set, the characters must also be valid UTF-8,
+ * or an encode_exception is thrown and nothing is written. The AVX2 and AVX-512
+ * kernels validate the chunks that they load to look for characters to escape.
  */
 json_force_inline void write_escaped(
     encode_context &context,
     const char *begin,
     const char *end) {
-#if defined(json_arch_x86)
-  if (json_likely(context.has_sse42)) {
-    return write_escaped_sse42(context, begin, end);
+  if (json_likely(!context.validate_utf8())) {
+    simd().write_escaped(context, begin, end);
+  } else {
+    simd().write_escaped_utf8(context, begin, end);
   }
-#endif  // defined(json_arch_x86)
-  write_escaped_scalar(context, begin, end);
 }
 
+/**
+ * The number of bytes that write_escaped(...) writes for the given characters.
+ */
+size_t escaped_size(const char *begin, const char *end);
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
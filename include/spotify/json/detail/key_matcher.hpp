@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * A key_matcher maps a fixed set of keys to their insertion index. It is built
+ * once, when a codec is set up, and is then used to look up keys straight from
+ * the input bytes, without first copying them into an std::string.
+ *
+ * Keys are hashed on their length and their first and last eight bytes, and
+ * are stored in an open addressed table that is kept at most half full. A hit
+ * is confirmed by comparing the full key.
+ */
+class key_matcher final {
+ public:
+  static const size_t npos = json_size_t_max;
+
+  key_matcher() : _slots(1, 0) {}
+
+  /**
+   * Add a key, which will have the index size() - 1. Returns false, and leaves
+   * the matcher as is, if the key has already been added.
+   */
+  bool insert(const std::string &key);
+
+  /**
+   * The index of the key [begin, end), or npos if it is not a known key.
+   */
+  json_force_inline size_t find(const char *begin, const char *end) const {
+    const auto size = static_cast<size_t>(end - begin);
+    for (auto slot = hash(begin, size) & _mask;; slot = (slot + 1) & _mask) {
+      const auto index = _slots[slot];
+      if (!index) {
+        return npos;
+      }
+
+      const auto &key = _keys[index - 1];
+      if (key.size() == size && std::memcmp(key.data(), begin, size) == 0) {
+        return (index - 1);
+      }
+    }
+  }
+
+  json_force_inline size_t size() const {
+    return _keys.size();
+  }
+
+ private:
+  json_force_inline static size_t hash(const char *data, const size_t size) {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    if (json_likely(size >= 8)) {
+      std::memcpy(&head, data, 8);
+      std::memcpy(&tail, data + size - 8, 8);
+    } else {
+      for (size_t i = 0; i < size; i++) {
+        head = (head << 8) | uint8_t(data[i]);
+      }
+    }
+
+    const auto h = (head ^ (tail * 0x9E3779B97F4A7C15ULL) ^ size) * 0xFF51AFD7ED558CCDULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+
+  void rehash(size_t num_slots);
+  void place(size_t index);
+
+  std::vector<std::string> _keys;
+  std::vector<uint32_t> _slots;  // index + 1 into _keys, or 0 if empty
+  size_t _mask = 0;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
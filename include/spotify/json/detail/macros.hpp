@@ -83,3 +83,27 @@
 #if defined(json_arch_x86_32) || defined(json_arch_x86_64)
   #define json_arch_x86
 #endif
+
+// AVX-512 intrinsics are only available in Visual Studio 2017 and later.
+#if defined(json_arch_x86_64) && (!defined(_MSC_VER) || _MSC_VER >= 1910)
+  #define json_simd_avx512
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+  #define json_arch_arm64
+#endif
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  #define json_big_endian
+#endif
+
+#if defined(_MSVC_LANG)
+  #define json_cplusplus _MSVC_LANG
+#else
+  #define json_cplusplus __cplusplus
+#endif  // defined(_MSVC_LANG)
+
+#if json_cplusplus >= 201703L
+  #define json_has_string_view
+#endif
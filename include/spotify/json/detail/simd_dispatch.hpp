@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * A table of the string scanning and escaping kernels that are best suited for
+ * the CPU that the process is running on.
+ */
+struct simd_dispatch {
+  void (*skip_any_simple_characters)(decode_context &context);
+  void (*skip_any_simple_characters_utf8)(decode_context &context);
+  void (*skip_any_whitespace)(decode_context &context);
+  void (*write_escaped)(encode_context &context, const char *begin, const char *end);
+  void (*write_escaped_utf8)(encode_context &context, const char *begin, const char *end);
+};
+
+/**
+ * Probe the CPU and pick the fastest available kernels. This is expensive and
+ * should only be called once; use simd() to get hold of the table.
+ */
+simd_dispatch resolve_simd_dispatch();
+
+/**
+ * The process-wide kernel table. The CPU is probed the first time this function
+ * is called, after which the table is shared by all decode and encode contexts.
+ */
+json_force_inline const simd_dispatch &simd() {
+  static const simd_dispatch dispatch = resolve_simd_dispatch();
+  return dispatch;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
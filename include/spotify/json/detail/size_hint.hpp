@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+template <typename T>
+struct has_reserve_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<U &>().reserve(std::declval<size_t>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * The most memory that a size_hint reserves for the elements of a container.
+ */
+constexpr size_t max_size_hint_bytes = 1024 * 1024;
+
+/**
+ * Remembers how many elements a codec decoded into its last container, so that
+ * the next container can be reserved up front instead of growing one element
+ * at a time. Documents of the same kind tend to have arrays of similar sizes,
+ * so this saves most of the reallocation and copying for large arrays. The
+ * hint is capped at max_size_hint_bytes worth of elements, and larger
+ * containers grow from there as usual, so an unusually large array cannot make
+ * the small ones that come after it allocate a lot of memory.
+ *
+ * The hint is a relaxed atomic, so a codec can be used by several threads at
+ * once. It is only written when it changes, to keep its cache line shared.
+ */
+template <typename container_type, bool = has_reserve_method<container_type>::value>
+class size_hint {
+ public:
+  size_hint() = default;
+  size_hint(const size_hint &other)
+      : _size(other._size.load(std::memory_order_relaxed)) {}
+
+  size_hint &operator=(const size_hint &other) {
+    _size.store(other._size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+  }
+
+  json_force_inline void reserve(const decode_context &context, container_type &container) const {
+    // Each element takes at least two bytes of input: the value and a comma.
+    const auto max_size = std::max<size_t>(1, max_size_hint_bytes / sizeof(typename container_type::value_type));
+    const auto hint = std::min(_size.load(std::memory_order_relaxed), max_size);
+    const auto size = std::min(hint, context.remaining() / 2);
+    if (size) {
+      container.reserve(size);
+    }
+  }
+
+  json_force_inline void record(const container_type &container) const {
+    const auto size = container.size();
+    if (json_unlikely(size != _size.load(std::memory_order_relaxed))) {
+      _size.store(size, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  mutable std::atomic<size_t> _size{0};
+};
+
+/**
+ * Containers without reserve(...), such as std::list and std::map, have no
+ * use for a hint.
+ */
+template <typename container_type>
+class size_hint<container_type, false> {
+ public:
+  json_force_inline void reserve(const decode_context &, container_type &) const {}
+  json_force_inline void record(const container_type &) const {}
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -18,6 +18,7 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/simd_dispatch.hpp>
 
 namespace spotify {
 namespace json {
@@ -25,8 +26,24 @@ namespace detail {
 
 void skip_any_simple_characters_scalar(decode_context &context);
 #if defined(json_arch_x86)
+void skip_any_simple_characters_sse2(decode_context &context);
 void skip_any_simple_characters_sse42(decode_context &context);
+void skip_any_simple_characters_avx2(decode_context &context);
 #endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+void skip_any_simple_characters_avx512(decode_context &context);
+#endif  // defined(json_simd_avx512)
+#if defined(json_arch_arm64)
+void skip_any_simple_characters_neon(decode_context &context);
+#endif  // defined(json_arch_arm64)
+
+void skip_any_simple_characters_utf8_scalar(decode_context &context);
+#if defined(json_arch_x86)
+void skip_any_simple_characters_utf8_avx2(decode_context &context);
+#endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+void skip_any_simple_characters_utf8_avx512(decode_context &context);
+#endif  // defined(json_simd_avx512)
 
 /**
  * Skip past the bytes of the string until either a " or a \ character is
@@ -34,20 +51,32 @@ void skip_any_simple_characters_sse42(decode_context &context);
  * at each step, by making sure that the context position is aligned to the
  * appropriate address and then reading and comparing several bytes in a
  * single read operation.
+ *
+ * If context.validate_utf8 is set, the skipped bytes must also be valid UTF-8,
+ * or a decode_exception is thrown. The AVX2 and AVX-512 kernels validate the
+ * chunks that they have already loaded; the others validate the skipped bytes
+ * in a second pass.
  */
 json_force_inline void skip_any_simple_characters(decode_context &context) {
-#if defined(json_arch_x86)
-  if (json_likely(context.has_sse42)) {
-    return skip_any_simple_characters_sse42(context);
+  if (json_likely(!context.validate_utf8)) {
+    simd().skip_any_simple_characters(context);
+  } else {
+    simd().skip_any_simple_characters_utf8(context);
   }
-#endif  // defined(json_arch_x86)
-  return skip_any_simple_characters_scalar(context);
 }
 
 void skip_any_whitespace_scalar(decode_context &context);
 #if defined(json_arch_x86)
+void skip_any_whitespace_sse2(decode_context &context);
 void skip_any_whitespace_sse42(decode_context &context);
+void skip_any_whitespace_avx2(decode_context &context);
 #endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+void skip_any_whitespace_avx512(decode_context &context);
+#endif  // defined(json_simd_avx512)
+#if defined(json_arch_arm64)
+void skip_any_whitespace_neon(decode_context &context);
+#endif  // defined(json_arch_arm64)
 
 /**
  * Skip past the bytes of the string until a non-whitespace character is
@@ -57,12 +86,7 @@ void skip_any_whitespace_sse42(decode_context &context);
  * single read operation.
  */
 json_force_inline void skip_any_whitespace(decode_context &context) {
-#if defined(json_arch_x86)
-  if (json_likely(context.has_sse42)) {
-    return skip_any_whitespace_sse42(context);
-  }
-#endif  // defined(json_arch_x86)
-  skip_any_whitespace_scalar(context);
+  simd().skip_any_whitespace(context);
 }
 
 }  // namespace detail
@@ -31,6 +31,16 @@ namespace detail {
  */
 void skip_value(decode_context &context);
 
+/**
+ * Like skip_value(...), except that objects and arrays are skipped as if
+ * context.skip_unchecked was set: only strings and the nesting of brackets are
+ * followed to find where they end, and they are not checked for being valid
+ * JSON. This is several times faster, but should only be used for trusted
+ * input. Other values, and containers that do not end, are skipped like
+ * usual, which also makes sure that truncated input still fails.
+ */
+void skip_value_unchecked(decode_context &context);
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
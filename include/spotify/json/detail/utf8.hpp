@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Find the first invalid UTF-8 sequence in [begin, end). Overlong encodings,
+ * surrogates (U+D800 through U+DFFF), code points above U+10FFFF and sequences
+ * that are cut short are all invalid. Returns 'end' if all of the characters
+ * are valid UTF-8.
+ */
+const char *find_invalid_utf8(const char *begin, const char *end);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
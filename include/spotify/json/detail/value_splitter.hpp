@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * A value_splitter finds where JSON values begin and end in input that comes
+ * in chunks, which may split the input anywhere, including in the middle of a
+ * string or an escape sequence. The values are either the elements of a single
+ * top-level array, or a sequence of values that are separated by whitespace
+ * (or nothing at all, for objects, arrays and strings).
+ *
+ * Values that are entirely within one chunk are returned in place. The start
+ * of a value that continues in the next chunk is copied to a buffer, so only
+ * one value is kept in memory at a time, not the whole input.
+ *
+ * Only the structure that is needed to find the end of a value is checked; the
+ * values themselves are expected to be validated by decoding them.
+ */
+class value_splitter final {
+ public:
+  explicit value_splitter(bool array_elements);
+
+  /**
+   * Make [data, data + size) the chunk that next() scans. The previous chunk
+   * must have been scanned to its end, i.e., next() must have returned false.
+   */
+  void push(const char *data, size_t size);
+
+  /**
+   * Scan the current chunk for the end of the next value. Return true if one
+   * was found, in which case value_data() and value_size() point to it until
+   * next() is called again. Return false when the chunk has been used up.
+   * Throws decode_exception if the input can not be split into values.
+   */
+  bool next();
+
+  /**
+   * Signal the end of the input. Return true if the input ended with a number
+   * or literal at the top level, which then is the last value. Throws
+   * decode_exception if the input ended in the middle of a value, or, for an
+   * array, before its closing bracket.
+   */
+  bool finish();
+
+  json_force_inline const char *value_data() const { return _value_data; }
+  json_force_inline size_t value_size() const { return _value_size; }
+
+  /**
+   * The offset of the current value from the start of the whole input.
+   */
+  json_force_inline size_t value_offset() const { return _value_offset; }
+
+ private:
+  enum class state : uint8_t {
+    before_array,
+    before_first_element,
+    before_value,
+    in_value,
+    after_element,
+    after_array
+  };
+
+  bool skip_whitespace();
+  void start_value();
+  bool scan_value();
+  void complete_value(const char *value_end);
+  bool end_of_chunk();
+  json_noreturn void fail(const char *error, ptrdiff_t d = 0) const;
+
+  const char *_chunk_begin = nullptr;
+  const char *_chunk_end = nullptr;
+  const char *_position = nullptr;
+  size_t _chunk_offset = 0;
+
+  const char *_value_begin = nullptr;
+  const char *_value_data = nullptr;
+  size_t _value_size = 0;
+  size_t _value_offset = 0;
+  std::string _buffer;
+
+  size_t _depth = 0;
+  bool _in_string = false;
+  bool _in_escape = false;
+  bool _in_scalar = false;
+
+  state _state;
+  const bool _array_elements;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
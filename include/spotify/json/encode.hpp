@@ -16,11 +16,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/encode_context_pool.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/encode_sink.hpp>
 #include <spotify/json/encoded_value.hpp>
 
 namespace spotify {
@@ -30,9 +34,9 @@ template <typename codec_type>
 json_never_inline std::string encode(
     const codec_type &codec,
     const typename codec_type::object_type &object) {
-  encode_context context;
-  codec.encode(context, object);
-  return std::string(context.data(), context.size());
+  const detail::pooled_encode_context context;
+  codec.encode(*context, object);
+  return std::string((*context).data(), (*context).size());
 }
 
 template <typename value_type>
@@ -40,6 +44,108 @@ json_never_inline std::string encode(const value_type &value) {
   return encode(default_codec<value_type>(), value);
 }
 
+/**
+ * Encode into a string that the caller keeps, so that its capacity is reused
+ * and encoding does not allocate once the string is large enough.
+ */
+template <typename codec_type>
+json_never_inline void encode_into(
+    const codec_type &codec,
+    const typename codec_type::object_type &object,
+    std::string &string) {
+  const detail::pooled_encode_context context;
+  codec.encode(*context, object);
+  string.assign((*context).data(), (*context).size());
+}
+
+/**
+ * Encode into an encode_context that the caller keeps. The context is cleared
+ * first, so that its buffer is reused; the JSON is in context.data().
+ */
+template <typename codec_type>
+json_never_inline void encode_into(
+    const codec_type &codec,
+    const typename codec_type::object_type &object,
+    encode_context &context) {
+  context.clear();
+  codec.encode(context, object);
+}
+
+template <typename value_type>
+json_never_inline void encode_into(const value_type &value, std::string &string) {
+  encode_into(default_codec<value_type>(), value, string);
+}
+
+template <typename value_type>
+json_never_inline void encode_into(const value_type &value, encode_context &context) {
+  encode_into(default_codec<value_type>(), value, context);
+}
+
+/**
+ * Encode to a sink through a buffer of the given size, which is written to the
+ * sink whenever it is full. See encode_sink.
+ */
+template <typename codec_type>
+json_never_inline void encode(
+    const codec_type &codec,
+    const typename codec_type::object_type &object,
+    encode_sink &sink,
+    const size_t buffer_size = 65536) {
+  encode_context context(sink, buffer_size);
+  codec.encode(context, object);
+  context.flush();
+}
+
+/**
+ * The number of bytes that encode(...) writes for the value. Most codecs work
+ * this out without encoding the value; see detail::encoded_size(...).
+ */
+template <typename codec_type>
+json_never_inline size_t encoded_size(
+    const codec_type &codec,
+    const typename codec_type::object_type &object) {
+  return detail::encoded_size(codec, object);
+}
+
+template <typename value_type>
+json_never_inline size_t encoded_size(const value_type &value) {
+  return json::encoded_size(default_codec<value_type>(), value);
+}
+
+/**
+ * Encode into a buffer that the caller provides, such as a registered network
+ * buffer or a slot in a shared memory ring, instead of one that is allocated
+ * and grown as needed. Returns the size of the JSON, which is the same as
+ * encoded_size(...) returns. Throws encode_exception if it does not fit in
+ * 'capacity' bytes; what is in the buffer is then unspecified.
+ *
+ * The JSON is written directly into 'data', through a buffer_sink. Codecs
+ * reserve more space than they use, e.g., six bytes per character when
+ * escaping a string, so close to the end of the buffer they would run out of
+ * it even though the JSON fits. Only from there on is the JSON encoded via a
+ * small buffer on the stack, which is copied to 'data' at the end. This is
+ * cheaper than working out the size of the JSON before writing it, and does
+ * not allocate.
+ */
+template <typename codec_type>
+json_never_inline size_t encode(
+    const codec_type &codec,
+    const typename codec_type::object_type &object,
+    char *data,
+    const size_t capacity) {
+  char buffer[2 * detail::max_encode_reservation];
+  buffer_sink sink(data, capacity);
+  encode_context context(sink, buffer, sizeof(buffer));
+  codec.encode(context, object);
+  context.flush();
+  return sink.size();
+}
+
+template <typename value_type>
+json_never_inline size_t encode(const value_type &value, char *data, const size_t capacity) {
+  return encode(default_codec<value_type>(), value, data, capacity);
+}
+
 template <typename codec_type>
 json_never_inline encoded_value encode_value(
     const codec_type &codec,
@@ -24,8 +24,9 @@
 #include <limits>
 #include <memory>
 
-#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_exception.hpp>
+#include <spotify/json/encode_sink.hpp>
 
 namespace spotify {
 namespace json {
@@ -34,22 +35,41 @@ namespace detail {
 /**
  * An encode_context has the information that is kept while encoding JSON with
  * codecs. It keeps a buffer of data that can be expanded and written to.
+ *
+ * An encode_context that is constructed with a sink writes its buffer to the
+ * sink when it is full, instead of growing it, so the memory that is needed to
+ * encode a value does not depend on its size. The last byte is kept, because
+ * append_or_replace(...) may have to replace it. Call flush() when done, to
+ * write the rest; data() and size() only cover what has not been written yet.
+ * If the sink has a direct_buffer(...), the context writes into that while the
+ * reservations fit there, and only uses its own buffer when they do not.
+ *
+ * An encode_context that is constructed with a buffer writes into that buffer
+ * and never allocates. The buffer is not grown when it is full; an
+ * encode_exception is thrown instead (or, with a sink, it is written to the
+ * sink, and only replaced by an allocated one if a single reservation is larger
+ * than it). Note that codecs reserve more space than they write, e.g., up to six
+ * bytes per character when escaping strings, so the buffer should have some
+ * room to spare. See encode(codec, value, data, capacity) in encode.hpp.
  */
 template <typename size_type = std::size_t>
 struct base_encode_context final {
   base_encode_context(const size_type capacity = 4096)
-      : has_sse42(detail::cpuid().has_sse42()),
-        _buf(static_cast<char *>(capacity ? std::malloc(capacity) : nullptr)),
-        _ptr(_buf),
-        _end(_buf + capacity),
-        _capacity(capacity) {
-    if (json_unlikely(!_buf && _capacity > 0)) {
-      throw std::bad_alloc();
-    }
-  }
+      : base_encode_context(nullptr, nullptr, capacity) {}
+
+  explicit base_encode_context(encode_sink &sink, const size_type capacity = 65536)
+      : base_encode_context(&sink, nullptr, capacity) {}
+
+  base_encode_context(char *buffer, const size_type capacity)
+      : base_encode_context(nullptr, buffer, capacity) {}
+
+  base_encode_context(encode_sink &sink, char *buffer, const size_type capacity)
+      : base_encode_context(&sink, buffer, capacity) {}
 
   ~base_encode_context() {
-    std::free(_buf);
+    if (_owns_buf) {
+      std::free(_staging);
+    }
   }
 
   json_force_inline char *reserve(const size_type reserved_bytes) {
@@ -88,6 +108,18 @@ struct base_encode_context final {
     _ptr = _buf;
   }
 
+  /**
+   * Write all of the data in the buffer to the sink, if there is one.
+   */
+  json_never_inline void flush() {
+    if (_sink && !empty()) {
+      _sink->write(_buf, size());
+      _buf = _staging;
+      _ptr = _staging;
+      _end = _staging + _capacity;
+    }
+  }
+
   json_force_inline const char *data() const {
     return _buf;
   }
@@ -100,23 +132,112 @@ struct base_encode_context final {
     return _capacity;
   }
 
+  /**
+   * The number of bytes that can be written before the buffer is full.
+   */
+  json_force_inline size_type remaining() const {
+    return static_cast<size_type>(_end - _ptr);
+  }
+
   json_force_inline bool empty() const {
     return (_ptr == _buf);
   }
 
+  /**
+   * Strings are not checked for valid UTF-8 by default. With validation turned
+   * on, encoding a string that is not valid UTF-8 throws an encode_exception.
+   * This is done while the strings are escaped, so it is cheap.
+   */
+  json_force_inline bool validate_utf8() const {
+    return _validate_utf8;
+  }
+
+  json_force_inline void set_validate_utf8(const bool validate_utf8) {
+    _validate_utf8 = validate_utf8;
+  }
+
   std::unique_ptr<void, decltype(std::free) *> steal_data() {
+    if (!_owns_buf || _buf != _staging) {
+      // The buffer belongs to someone else, so hand out a copy of it instead.
+      const auto copy = std::malloc(size() ? size() : 1);
+      if (json_unlikely(!copy)) {
+        throw std::bad_alloc();
+      }
+      std::memcpy(copy, _buf, size());
+      _ptr = _buf;
+      return std::unique_ptr<void, decltype(std::free) *>(copy, &std::free);
+    }
+
     const auto data = _buf;
     _buf = nullptr;
     _ptr = nullptr;
     _end = nullptr;
+    _staging = nullptr;
     _capacity = 0;
     return std::unique_ptr<void, decltype(std::free) *>(data, &std::free);
   }
 
-  const bool has_sse42;
-
  private:
-  json_never_inline void grow_buffer(const size_type num_bytes) {
+  base_encode_context(encode_sink *sink, char *buffer, const size_type capacity)
+      : _buf(buffer ? buffer : static_cast<char *>(capacity ? std::malloc(capacity) : nullptr)),
+        _ptr(_buf),
+        _end(_buf + capacity),
+        _staging(_buf),
+        _capacity(capacity),
+        _sink(sink),
+        _owns_buf(!buffer) {
+    if (json_unlikely(!_buf && _capacity > 0)) {
+      throw std::bad_alloc();
+    }
+
+    std::size_t direct_capacity = 0;
+    if (const auto direct = (_sink ? _sink->direct_buffer(direct_capacity) : nullptr)) {
+      if (direct_capacity <= std::numeric_limits<size_type>::max()) {
+        _buf = direct;
+        _ptr = direct;
+        _end = direct + direct_capacity;
+      }
+    }
+  }
+
+  json_never_inline void grow_buffer(size_type num_bytes) {
+    auto kept_size = size_type(0);
+    auto kept = char(0);
+    if (_sink) {
+      // Write all but the last byte, which may still be replaced, and go on in
+      // the sink's own memory if the reservation fits there. Otherwise go on in
+      // our buffer, which is only grown if a single reservation is larger than it.
+      kept_size = (empty() ? 0 : 1);
+      const auto flushed_size = size_type(size() - kept_size);
+      if (flushed_size) {
+        _sink->write(_buf, flushed_size);
+      }
+      kept = (kept_size ? _buf[flushed_size] : 0);
+      if (json_unlikely(num_bytes + kept_size < num_bytes)) {
+        throw std::bad_alloc();
+      }
+      num_bytes += kept_size;
+
+      std::size_t direct_capacity = 0;
+      const auto direct = _sink->direct_buffer(direct_capacity);
+      if (direct && direct_capacity >= num_bytes) {
+        _buf = direct;
+        _end = direct + std::min<std::size_t>(direct_capacity, std::numeric_limits<size_type>::max());
+      } else {
+        _buf = _staging;
+        _end = _staging + _capacity;
+      }
+
+      _ptr = _buf;
+      if (static_cast<size_type>(_end - _ptr) >= num_bytes) {
+        _ptr[0] = kept;
+        _ptr += kept_size;
+        return;
+      }
+    } else if (json_unlikely(!_owns_buf)) {
+      throw encode_exception("The encoded JSON does not fit in the buffer");
+    }
+
     const auto old_size = size();
     const auto new_size = size_type(old_size + num_bytes);
     if (json_unlikely(new_size < old_size)) {
@@ -135,22 +256,34 @@ struct base_encode_context final {
 
     // Regardless of what capacity we think we want, we need to ensure that it
     // is at least as large as the reserved size. We avoid doing any arithmetics
-    // here to not have to check for overflow yet again.
+    // here to not have to check for overflow yet again. A buffer that belongs
+    // to someone else is empty here, since there is a sink, so it is replaced.
     const auto actual_capacity = std::max(new_size, new_capacity);
-    _buf = static_cast<char *>(std::realloc(_buf, actual_capacity));
-    if (json_unlikely(!_buf)) {
+    const auto new_buf = (_owns_buf ? std::realloc(_buf, actual_capacity) : std::malloc(actual_capacity));
+    if (json_unlikely(!new_buf)) {
       throw std::bad_alloc();
     }
 
+    _buf = static_cast<char *>(new_buf);
     _ptr = _buf + old_size;
     _end = _buf + actual_capacity;
+    _staging = _buf;
     _capacity = actual_capacity;
+    _owns_buf = true;
+    if (kept_size) {
+      _ptr[0] = kept;
+      _ptr += kept_size;
+    }
   }
 
   char *_buf;
   char *_ptr;
   const char *_end;
+  char *_staging;  // Our own buffer; _buf may point into the sink instead
   size_type _capacity;
+  encode_sink *_sink;
+  bool _owns_buf;
+  bool _validate_utf8 = false;
 };
 
 }  // namespace detail
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * An encode_sink is where an encode_context that is constructed with it writes
+ * its buffer when it is full, so that encoding a large value does not need a
+ * buffer that holds all of it. See encode_context.
+ */
+class encode_sink {
+ public:
+  virtual ~encode_sink() = default;
+
+  /**
+   * Write the data somewhere. The data is only valid during the call.
+   */
+  virtual void write(const char *data, size_t size) = 0;
+
+  /**
+   * Sinks that keep the data in memory can return where the next data goes and
+   * how many bytes fit there, so that an encode_context writes the data there
+   * directly instead of copying it from its own buffer. The context then calls
+   * write(...) with that pointer. Other sinks return nullptr.
+   */
+  virtual char *direct_buffer(size_t &capacity) {
+    capacity = 0;
+    return nullptr;
+  }
+};
+
+/**
+ * Writes to a file descriptor, such as a file or a socket. Throws
+ * std::system_error if writing fails. The file descriptor is not closed.
+ */
+class fd_sink final : public encode_sink {
+ public:
+  explicit fd_sink(int fd);
+  void write(const char *data, size_t size) override;
+
+ private:
+  int _fd;
+};
+
+/**
+ * Writes to a std::ostream. Throws std::ios_base::failure if the stream fails.
+ */
+class ostream_sink final : public encode_sink {
+ public:
+  explicit ostream_sink(std::ostream &stream);
+  void write(const char *data, size_t size) override;
+
+ private:
+  std::ostream &_stream;
+};
+
+/**
+ * Calls a function with each piece of data.
+ */
+class callback_sink final : public encode_sink {
+ public:
+  using callback_type = std::function<void (const char *data, size_t size)>;
+
+  explicit callback_sink(callback_type callback);
+  void write(const char *data, size_t size) override;
+
+ private:
+  callback_type _callback;
+};
+
+/**
+ * Writes into a fixed size buffer. Throws encode_exception if it is full. An
+ * encode_context writes into the buffer directly while it has room.
+ */
+class buffer_sink final : public encode_sink {
+ public:
+  buffer_sink(char *data, size_t capacity);
+  void write(const char *data, size_t size) override;
+  char *direct_buffer(size_t &capacity) override;
+
+  /**
+   * The number of bytes that have been written to the buffer.
+   */
+  json_force_inline size_t size() const { return _size; }
+
+ private:
+  char *_data;
+  size_t _capacity;
+  size_t _size = 0;
+};
+
+/**
+ * Keeps each piece of data in a block of its own, so that the output can be
+ * written with a single gather call such as writev(...) or sendmsg(...), and
+ * is never copied into one large buffer.
+ */
+class gather_sink final : public encode_sink {
+ public:
+  struct buffer {
+    const char *data;
+    size_t size;
+  };
+
+  void write(const char *data, size_t size) override;
+
+  /**
+   * The blocks that have been written, in order. They are valid until the sink
+   * is destroyed or cleared, also when more is written to it in the meantime.
+   * They have the same layout as struct iovec on POSIX systems.
+   */
+  std::vector<buffer> buffers() const;
+
+  /**
+   * The total size of the blocks.
+   */
+  json_force_inline size_t size() const { return _size; }
+
+  void clear();
+
+ private:
+  std::deque<std::string> _blocks;  // a deque never moves its elements when it grows
+  size_t _size = 0;
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -16,12 +16,19 @@
 
 #pragma once
 
+#include <spotify/json/arena.hpp>
+#include <spotify/json/chunked_decoder.hpp>
 #include <spotify/json/codec.hpp>
 #include <spotify/json/decode.hpp>
+#include <spotify/json/decode_batch.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_exception.hpp>
+#include <spotify/json/encode_sink.hpp>
 #include <spotify/json/encode_context.hpp>
 #include <spotify/json/encoded_value.hpp>
+#include <spotify/json/lazy.hpp>
+#include <spotify/json/string_ref.hpp>
+#include <spotify/json/structural_index.hpp>
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+template <typename codec_type>
+class lazy_t;
+
+}  // namespace codec
+
+namespace detail {
+
+template <typename T>
+class lazy_decoder {
+ public:
+  virtual ~lazy_decoder() = default;
+  virtual T decode(decode_context &context) const = 0;
+};
+
+}  // namespace detail
+
+/**
+ * A value that is decoded when it is first accessed rather than when the JSON
+ * that it is part of is decoded. Until then, it refers to its JSON in the
+ * input, so the input must outlive it, just like for a string_ref. The decoded
+ * value is cached, so later accesses are free.
+ *
+ * A lazy value that has not been assigned to is encoded by copying its JSON as
+ * it is, whether or not it has been decoded. This makes fields that are passed
+ * through without being looked at nearly free to both decode and encode.
+ *
+ * Decoding fails with a decode_exception, whose offset is counted from the
+ * start of the value. Since the first access changes the cached value, a lazy
+ * value that has not been decoded can not be read by several threads at once.
+ */
+template <typename T>
+class lazy final {
+ public:
+  using value_type = T;
+
+  lazy()
+      : _value(),
+        _data(nullptr),
+        _size(0),
+        _decoded(true) {}
+
+  lazy(T value)
+      : _value(std::move(value)),
+        _data(nullptr),
+        _size(0),
+        _decoded(true) {}
+
+  /**
+   * True if the value has been decoded, or if it was not decoded from JSON.
+   */
+  bool is_decoded() const { return _decoded; }
+
+  const T &get() const {
+    if (json_unlikely(!_decoded)) {
+      decode();
+    }
+    return _value;
+  }
+
+  const T &operator*() const { return get(); }
+  const T *operator->() const { return &get(); }
+
+ private:
+  template <typename codec_type>
+  friend class codec::lazy_t;
+
+  lazy(
+      const char *data,
+      const std::size_t size,
+      std::shared_ptr<const detail::lazy_decoder<T>> decoder,
+      const decode_context &context)
+      : _data(data),
+        _size(size),
+        _decoder(std::move(decoder)),
+        _decoded(false),
+        _validate_utf8(context.validate_utf8),
+        _skip_unchecked(context.skip_unchecked) {}
+
+  json_never_inline void decode() const {
+    auto context = decode_context(_data, _size);
+    context.validate_utf8 = _validate_utf8;
+    context.skip_unchecked = _skip_unchecked;
+    _value = _decoder->decode(context);
+    detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+    _decoded = true;
+  }
+
+  mutable T _value;
+  const char *_data;
+  std::size_t _size;
+  std::shared_ptr<const detail::lazy_decoder<T>> _decoder;
+  mutable bool _decoded;
+  bool _validate_utf8 = false;
+  bool _skip_unchecked = false;
+};
+
+}  // namespace json
+}  // namespace spotify
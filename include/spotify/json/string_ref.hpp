@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <spotify/json/detail/macros.hpp>
+
+#if defined(json_has_string_view)
+#include <string_view>
+#endif  // defined(json_has_string_view)
+
+namespace spotify {
+namespace json {
+
+/**
+ * A string that usually refers to characters owned by someone else, typically
+ * the JSON input that it was decoded from. Strings that are decoded from JSON
+ * input with escape sequences cannot refer to the input, since their contents
+ * differ from it. Such strings own a copy of their unescaped characters, which
+ * is shared by all copies of the string_ref.
+ *
+ * A string_ref that refers to the input is only valid for as long as the input
+ * is. This makes it suitable for short-lived objects, such as decoded requests,
+ * where the cost of allocating a std::string per string value adds up.
+ *
+ * With C++17, a string_ref converts implicitly to a std::string_view.
+ */
+class string_ref final {
+ public:
+  using const_iterator = const char *;
+  using iterator = const_iterator;
+
+  string_ref()
+      : _data(""),
+        _size(0) {}
+
+  string_ref(const char *data, const std::size_t size)
+      : _data(data),
+        _size(size) {}
+
+  string_ref(const char *cstr)
+      : string_ref(cstr, std::strlen(cstr)) {}
+
+  string_ref(const std::string &string)
+      : string_ref(string.data(), string.size()) {}
+
+#if defined(json_has_string_view)
+  string_ref(const std::string_view string)
+      : string_ref(string.data(), string.size()) {}
+#endif  // defined(json_has_string_view)
+
+  /**
+   * Create a string_ref that owns its characters.
+   */
+  static string_ref owning(std::string &&string) {
+    const auto owned = std::make_shared<const std::string>(std::move(string));
+    string_ref ref(owned->data(), owned->size());
+    ref._owned = std::move(owned);
+    return ref;
+  }
+
+  const char *data() const { return _data; }
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  const_iterator begin() const { return _data; }
+  const_iterator end() const { return _data + _size; }
+
+  char operator[](const std::size_t index) const { return _data[index]; }
+
+  /**
+   * True if this string_ref owns its characters, i.e., if it stays valid when
+   * the input that it was decoded from goes away.
+   */
+  bool is_owning() const { return static_cast<bool>(_owned); }
+
+  std::string str() const { return std::string(_data, _size); }
+  explicit operator std::string() const { return str(); }
+
+#if defined(json_has_string_view)
+  operator std::string_view() const { return std::string_view(_data, _size); }
+#endif  // defined(json_has_string_view)
+
+  int compare(const string_ref &other) const {
+    const auto common_size = std::min(_size, other._size);
+    const auto result = (common_size ? std::memcmp(_data, other._data, common_size) : 0);
+    return (result ? result : (_size < other._size ? -1 : (_size > other._size ? 1 : 0)));
+  }
+
+ private:
+  const char *_data;
+  std::size_t _size;
+  std::shared_ptr<const std::string> _owned;
+};
+
+inline bool operator==(const string_ref &a, const string_ref &b) {
+  return (a.size() == b.size() && (a.empty() || !std::memcmp(a.data(), b.data(), a.size())));
+}
+
+inline bool operator!=(const string_ref &a, const string_ref &b) { return !(a == b); }
+inline bool operator<(const string_ref &a, const string_ref &b) { return a.compare(b) < 0; }
+inline bool operator<=(const string_ref &a, const string_ref &b) { return a.compare(b) <= 0; }
+inline bool operator>(const string_ref &a, const string_ref &b) { return a.compare(b) > 0; }
+inline bool operator>=(const string_ref &a, const string_ref &b) { return a.compare(b) >= 0; }
+
+inline std::ostream &operator<<(std::ostream &stream, const string_ref &string) {
+  return stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+}
+
+}  // namespace json
+}  // namespace spotify
+
+namespace std {
+
+/**
+ * FNV-1a, so that a string_ref can be used as a std::unordered_map key without
+ * having to create a std::string to hash.
+ */
+template <>
+struct hash<spotify::json::string_ref> {
+  size_t operator()(const spotify::json::string_ref &string) const {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const auto c : string) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ULL;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+}  // namespace std
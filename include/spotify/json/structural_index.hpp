@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A structural_index is built in a single SIMD pass over a JSON document
+ * (stage 1) and records where every token starts: the structural characters
+ * {}[]:, outside of strings, the opening quote of every string and the first
+ * character of every number and literal. It also pairs up each { and [ with
+ * its closing } or ].
+ *
+ * A decode_context that is constructed with an index (stage 2) uses it to jump
+ * over whitespace between tokens and to skip entire objects and arrays in
+ * constant time, instead of scanning them byte by byte. Skipped containers are
+ * only checked for balanced brackets and terminated strings, not for the full
+ * JSON grammar, so this mode should only be used for trusted input.
+ *
+ * If the document is not balanced, has an unterminated string or is larger
+ * than 4 GB, the index is not valid and decode contexts that are constructed
+ * with it decode the document like usual.
+ *
+ * The index keeps a cursor into the token list, so it can only be used by one
+ * decode_context at a time. The indexed data must outlive the index.
+ */
+class structural_index final {
+ public:
+  structural_index(const char *begin, const char *end);
+  structural_index(const char *data, size_t size);
+
+  json_force_inline bool valid() const {
+    return _valid;
+  }
+
+  json_force_inline const char *begin() const {
+    return _begin;
+  }
+
+  json_force_inline const char *end() const {
+    return _end;
+  }
+
+  /**
+   * Number of tokens in the document, or zero if the index is not valid.
+   */
+  json_force_inline size_t size() const {
+    return _tokens.size();
+  }
+
+  /**
+   * The first token that starts at or after the given position, or end() if
+   * there are no more tokens.
+   */
+  const char *next_token(const char *position);
+
+  /**
+   * If the given position points at whitespace, return the position of the
+   * next token (or end()). Otherwise the position is returned as is. Since a
+   * non-whitespace character that follows whitespace always starts a token,
+   * this is exactly equivalent to skipping all whitespace characters.
+   */
+  json_force_inline const char *skip_whitespace(const char *position) {
+    return (position != _end && is_space(*position) ? next_token(position) : position);
+  }
+
+  /**
+   * Given the position of a { or [, return the position right after the
+   * matching } or ]. The position must be the start of a token.
+   */
+  const char *skip_container(const char *position);
+
+ private:
+  json_force_inline static bool is_space(const char c) {
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+  }
+
+  void build();
+  void match_containers();
+  size_t find_token(uint32_t offset);
+
+  const char *_begin;
+  const char *_end;
+  bool _valid;
+  size_t _cursor;
+  std::vector<uint32_t> _tokens;
+  std::vector<uint32_t> _matches;
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/arena.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Blocks are kept in a singly linked list, with the most recently allocated
+ * (and largest) block first. The usable memory follows the header.
+ */
+struct arena::block {
+  block *next;
+  size_t size;
+
+  char *begin() { return reinterpret_cast<char *>(this + 1); }
+  char *end() { return begin() + size; }
+};
+
+arena::arena(const size_t initial_block_size)
+    : _blocks(nullptr),
+      _position(nullptr),
+      _end(nullptr),
+      _next_block_size(std::max(initial_block_size, sizeof(block))) {}
+
+arena::~arena() {
+  while (_blocks) {
+    const auto next = _blocks->next;
+    std::free(_blocks);
+    _blocks = next;
+  }
+}
+
+void arena::reset() {
+  if (!_blocks) {
+    return;
+  }
+
+  // Keep the most recent block, it is the largest one. Once the arena has
+  // grown to fit the typical request, resetting it frees nothing.
+  auto next = _blocks->next;
+  _blocks->next = nullptr;
+  while (next) {
+    const auto after = next->next;
+    std::free(next);
+    next = after;
+  }
+
+  _position = _blocks->begin();
+  _end = _blocks->end();
+}
+
+size_t arena::capacity() const {
+  size_t capacity = 0;
+  for (auto b = _blocks; b; b = b->next) {
+    capacity += b->size;
+  }
+  return capacity;
+}
+
+void *arena::allocate_in_new_block(const size_t size, const size_t alignment) {
+  const auto min_size = size + alignment;
+  if (json_unlikely(min_size < size || min_size > std::numeric_limits<size_t>::max() / 2)) {
+    throw std::bad_alloc();
+  }
+
+  const auto block_size = std::max(_next_block_size, min_size);
+  const auto memory = std::malloc(sizeof(block) + block_size);
+  if (json_unlikely(!memory)) {
+    throw std::bad_alloc();
+  }
+
+  const auto new_block = static_cast<block *>(memory);
+  new_block->next = _blocks;
+  new_block->size = block_size;
+  _blocks = new_block;
+  _position = new_block->begin();
+  _end = new_block->end();
+  _next_block_size = block_size * 2;
+
+  return allocate(size, alignment);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/value_splitter.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+std::vector<batch_record> split_lines(const char *data, const size_t size) {
+  std::vector<batch_record> records;
+  const auto end = data + size;
+  auto line = data;
+
+  while (line != end) {
+    auto line_end = static_cast<const char *>(std::memchr(line, '\n', end - line));
+    line_end = (line_end ? line_end : end);
+
+    decode_context context(line, line_end);
+    skip_any_whitespace(context);
+    if (context.position != line_end) {
+      records.push_back(batch_record{ line, size_t(line_end - line), size_t(line - data) });
+    }
+
+    line = (line_end == end ? end : line_end + 1);
+  }
+
+  return records;
+}
+
+std::vector<batch_record> split_concatenated(
+    const char *data,
+    const size_t size,
+    std::vector<batch_error> &errors) {
+  std::vector<batch_record> records;
+  value_splitter splitter(false);
+
+  try {
+    splitter.push(data, size);
+    while (splitter.next()) {
+      records.push_back(batch_record{ splitter.value_data(), splitter.value_size(), splitter.value_offset() });
+    }
+    if (splitter.finish()) {
+      // A number or literal at the end of the buffer. It was copied to the
+      // splitter's buffer, but it is also at the end of the input.
+      const auto offset = splitter.value_offset();
+      records.push_back(batch_record{ data + offset, size - offset, offset });
+    }
+  } catch (const decode_exception &exception) {
+    errors.push_back(batch_error{ records.size(), exception.offset(), exception.what() });
+  }
+
+  return records;
+}
+
+namespace {
+
+/**
+ * Threads that are kept between calls to parallel_for(...), so that small
+ * batches do not pay for starting threads. The pool grows to the largest
+ * number of helper threads that has been asked for. It runs one job at a
+ * time; a caller that finds it busy does the work on its own thread.
+ */
+class thread_pool final {
+ public:
+  static thread_pool &instance() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  /**
+   * Run 'work' on the calling thread and on up to 'num_helpers' threads of the
+   * pool, and return when all of them have returned from it. Helpers that have
+   * not started by the time the calling thread is done are not started at all,
+   * so 'work' should return once there is nothing left to do.
+   */
+  void run(const unsigned num_helpers, const std::function<void ()> &work) {
+    std::unique_lock<std::mutex> run_lock(_run_mutex, std::try_to_lock);
+    if (!run_lock) {
+      work();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      while (_threads.size() < num_helpers) {
+        _threads.emplace_back([this]{ help(); });
+      }
+      _work = &work;
+      _wanted = num_helpers;
+    }
+    _wake.notify_all();
+
+    work();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _wanted = 0;
+    _done.wait(lock, [this]{ return _active == 0; });
+    _work = nullptr;
+  }
+
+ private:
+  thread_pool() = default;
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _wake.notify_all();
+    for (auto &thread : _threads) {
+      thread.join();
+    }
+  }
+
+  void help() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+      _wake.wait(lock, [this]{ return _stop || _wanted > 0; });
+      if (_stop) {
+        return;
+      }
+
+      _wanted--;
+      _active++;
+      const auto work = _work;
+      lock.unlock();
+      (*work)();
+      lock.lock();
+      if (--_active == 0) {
+        _done.notify_all();
+      }
+    }
+  }
+
+  std::mutex _run_mutex;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _done;
+  std::vector<std::thread> _threads;
+  const std::function<void ()> *_work = nullptr;
+  unsigned _wanted = 0;
+  unsigned _active = 0;
+  bool _stop = false;
+};
+
+}  // namespace
+
+void parallel_for(
+    const size_t size,
+    const unsigned threads,
+    const std::function<void (size_t begin, size_t end)> &body) {
+  // Small ranges balance the load between the threads, but each one costs an
+  // atomic increment, so there are about 16 of them per thread, and no more
+  // than 64 records in each, so that a run of large records is shared too.
+  const auto num_threads = std::max(1u, std::min<unsigned>(threads, unsigned(std::min<size_t>(size, ~0u))));
+  const auto range_size = std::min<size_t>(64, std::max<size_t>(1, size / (size_t(num_threads) * 16)));
+  if (num_threads == 1) {
+    body(0, size);
+    return;
+  }
+
+  std::atomic<size_t> next_range{0};
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+
+  thread_pool::instance().run(num_threads - 1, [&]{
+    try {
+      while (true) {
+        const auto begin = next_range.fetch_add(range_size, std::memory_order_relaxed);
+        if (begin >= size) {
+          return;
+        }
+        body(begin, std::min(begin + range_size, size));
+      }
+    } catch (...) {
+      // Make the other threads stop after their current range.
+      next_range.store(size, std::memory_order_relaxed);
+      std::lock_guard<std::mutex> lock(exception_mutex);
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  });
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
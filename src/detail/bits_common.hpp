@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Count the number of trailing zero bits in a mask produced by a vector
+ * comparison, i.e., the index of the first matching byte. The mask must not be
+ * zero.
+ */
+json_force_inline unsigned count_trailing_zeros(const uint32_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif  // defined(_MSC_VER)
+}
+
+json_force_inline unsigned count_trailing_zeros(const uint64_t mask) {
+#if defined(_MSC_VER) && defined(json_arch_x86_64)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+  const auto lo = static_cast<uint32_t>(mask);
+  return (lo ?
+      count_trailing_zeros(lo) :
+      count_trailing_zeros(static_cast<uint32_t>(mask >> 32)) + 32);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif  // defined(_MSC_VER)
+}
+
+/**
+ * Count the number of leading zero bits in a 64 bit value. The value must not
+ * be zero.
+ */
+json_force_inline unsigned count_leading_zeros(const uint64_t value) {
+#if defined(_MSC_VER) && defined(json_arch_x86_64)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<unsigned>(63 - index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  const auto hi = static_cast<uint32_t>(value >> 32);
+  if (hi) {
+    _BitScanReverse(&index, hi);
+    return static_cast<unsigned>(31 - index);
+  }
+  _BitScanReverse(&index, static_cast<uint32_t>(value));
+  return static_cast<unsigned>(63 - index);
+#else
+  return static_cast<unsigned>(__builtin_clzll(value));
+#endif  // defined(_MSC_VER)
+}
+
+/**
+ * Count the number of set bits in a 64 bit value.
+ */
+json_force_inline unsigned count_ones(const uint64_t value) {
+#if defined(_MSC_VER) && defined(json_arch_x86_64)
+  return static_cast<unsigned>(__popcnt64(value));
+#elif defined(_MSC_VER)
+  return static_cast<unsigned>(__popcnt(static_cast<uint32_t>(value)) + __popcnt(static_cast<uint32_t>(value >> 32)));
+#else
+  return static_cast<unsigned>(__builtin_popcountll(value));
+#endif  // defined(_MSC_VER)
+}
+
+struct uint128 {
+  uint64_t lo;
+  uint64_t hi;
+};
+
+/**
+ * The full 128 bit product of two 64 bit values.
+ */
+json_force_inline uint128 multiply(const uint64_t a, const uint64_t b) {
+  uint128 result;
+#if defined(__SIZEOF_INT128__)
+  const auto product = static_cast<unsigned __int128>(a) * b;
+  result.lo = static_cast<uint64_t>(product);
+  result.hi = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(json_arch_x86_64)
+  result.lo = _umul128(a, b, &result.hi);
+#else
+  const auto a_lo = (a & 0xFFFFFFFF);
+  const auto a_hi = (a >> 32);
+  const auto b_lo = (b & 0xFFFFFFFF);
+  const auto b_hi = (b >> 32);
+  const auto lo_lo = a_lo * b_lo;
+  const auto hi_lo = a_hi * b_lo;
+  const auto lo_hi = a_lo * b_hi;
+  const auto hi_hi = a_hi * b_hi;
+  const auto cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  result.lo = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  result.hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+#endif  // defined(__SIZEOF_INT128__)
+  return result;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
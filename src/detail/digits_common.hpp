@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <spotify/json/detail/macros.hpp>
+
+#include "bits_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const uint64_t powers_of_ten[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL };
+
+const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Count the number of decimal digits in 'value', without branching on each
+ * power of ten. The bit length times log10(2) (1233 / 4096) is either exact or
+ * one too large, which is sorted out with a single table lookup.
+ */
+json_force_inline unsigned count_digits(const uint64_t value) {
+  const auto v = (value | 1);  // 0 has one digit, and setting the lowest bit never adds one
+  const auto approximation = ((64 - count_leading_zeros(v)) * 1233) >> 12;
+  return approximation + 1 - (v < powers_of_ten[approximation]);
+}
+
+/**
+ * Write the 'count' lowest decimal digits of 'value', including leading zeros,
+ * so that the last digit ends up just before 'end'. The digits are written two
+ * at a time, from the digit_pairs table.
+ */
+json_force_inline void write_digits_32(char *end, uint32_t value, int count) {
+  for (; count >= 2; count -= 2) {
+    end -= 2;
+    std::memcpy(end, &digit_pairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (count) {
+    end[-1] = static_cast<char>('0' + value % 10);
+  }
+}
+
+/**
+ * Like write_digits_32(...), but for 64 bit values. The digits are written in
+ * chunks of eight, since 32 bit divisions are cheaper than 64 bit ones.
+ */
+json_force_inline void write_digits(char *end, uint64_t value, int count) {
+  for (; count > 8; count -= 8) {
+    write_digits_32(end, static_cast<uint32_t>(value % 100000000), 8);
+    value /= 100000000;
+    end -= 8;
+  }
+  write_digits_32(end, static_cast<uint32_t>(value), count);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/encode_context_pool.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * Contexts that have grown past this size are freed instead of kept.
+ */
+const size_t max_pooled_capacity = 1024 * 1024;
+
+struct context_pool {
+  std::unique_ptr<encode_context> context;
+  bool in_use = false;
+};
+
+context_pool &thread_pool() {
+  static thread_local context_pool pool;
+  return pool;
+}
+
+}  // namespace
+
+pooled_encode_context::pooled_encode_context() {
+  auto &pool = thread_pool();
+  if (json_unlikely(pool.in_use)) {
+    _owned.reset(new encode_context());
+    _context = _owned.get();
+    return;
+  }
+
+  if (!pool.context) {
+    pool.context.reset(new encode_context());
+  }
+
+  pool.in_use = true;
+  _context = pool.context.get();
+  _context->clear();
+}
+
+pooled_encode_context::~pooled_encode_context() {
+  if (_owned) {
+    return;
+  }
+
+  auto &pool = thread_pool();
+  if (json_unlikely(pool.context->capacity() > max_pooled_capacity)) {
+    pool.context.reset();
+  }
+  pool.in_use = false;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -16,139 +16,103 @@
 
 #include <spotify/json/detail/encode_integer.hpp>
 
+#include <cstring>
+
+#include "digits_common.hpp"
+
 namespace spotify {
 namespace json {
 namespace detail {
 namespace {
 
-template <typename T, int num_digits>
-struct negative final {
-  json_force_inline static void encode(encode_context &context, T value) {
-    constexpr auto num_bytes = num_digits + 1;  // + 1 for the '-' sign character
-    const auto p = context.reserve(num_bytes);
-    p[0] = '-';
-    for (int i = num_digits; i >= 1; i--) {
-      const auto v = value;
-      value /= 10;
-      p[i] = ('0' + static_cast<uint8_t>(value * 10 - v));
-    }
-    context.advance(num_bytes);
+json_force_inline void write_2_digits(char *out, const uint32_t value) {
+  std::memcpy(out, &digit_pairs[value * 2], 2);
+}
+
+json_force_inline void write_4_digits(char *out, const uint32_t value) {
+  write_2_digits(out + 0, value / 100);
+  write_2_digits(out + 2, value % 100);
+}
+
+json_force_inline void write_8_digits(char *out, const uint32_t value) {
+  write_4_digits(out + 0, value / 10000);
+  write_4_digits(out + 4, value % 10000);
+}
+
+/**
+ * Write the decimal digits of 'value' to 'out', which must have room for at
+ * least 10 characters. The digits are first written with leading zeros into a
+ * fixed number of characters, in independent blocks of two, four and eight
+ * digits. The leading zeros are then skipped by copying with an offset. This
+ * way, the only branch depends on the magnitude of the value, which is usually
+ * predictable, and not on the exact number of digits, which is not.
+ */
+json_force_inline int write_integer_32(char *out, const uint32_t value) {
+  const auto num_digits = static_cast<int>(count_digits(value));
+  char buffer[16];
+  if (value < 100000000) {
+    write_8_digits(buffer, value);
+    std::memcpy(out, buffer + 8 - num_digits, 8);
+  } else {
+    write_2_digits(buffer, value / 100000000);
+    write_8_digits(buffer + 2, value % 100000000);
+    std::memcpy(out, buffer + 10 - num_digits, 10);
   }
-};
-
-template <typename T, int num_digits>
-struct positive final {
-  json_force_inline static void encode(encode_context &context, T value) {
-    constexpr auto num_bytes = num_digits;
-    const auto p = context.reserve(num_bytes);
-    for (int i = num_digits - 1; i >= 0; i--) {
-      const auto v = value;
-      value /= 10;
-      p[i] = ('0' + static_cast<uint8_t>(v - value * 10));
-    }
-    context.advance(num_bytes);
+  return num_digits;
+}
+
+/**
+ * Like write_integer_32(...), but for 64 bit values. The 'out' buffer must
+ * have room for at least 20 characters.
+ */
+json_force_inline int write_integer_64(char *out, const uint64_t value) {
+  if (value <= UINT32_MAX) {
+    return write_integer_32(out, static_cast<uint32_t>(value));
+  }
+
+  const auto num_digits = static_cast<int>(count_digits(value));
+  char buffer[24];
+  if (value < 10000000000000000ULL) {
+    write_8_digits(buffer + 0, static_cast<uint32_t>(value / 100000000));
+    write_8_digits(buffer + 8, static_cast<uint32_t>(value % 100000000));
+    std::memcpy(out, buffer + 16 - num_digits, 16);
+  } else {
+    const auto top = value / 10000000000000000ULL;
+    const auto rest = value % 10000000000000000ULL;
+    write_4_digits(buffer + 0, static_cast<uint32_t>(top));
+    write_8_digits(buffer + 4, static_cast<uint32_t>(rest / 100000000));
+    write_8_digits(buffer + 12, static_cast<uint32_t>(rest % 100000000));
+    std::memcpy(out, buffer + 20 - num_digits, 20);
   }
-};
+  return num_digits;
+}
 
 }  // namespace
 
 void encode_negative_integer_32(encode_context &context, int32_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = int_fast ## bits ## _t; \
-    return negative<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value > cutoff ## LL) ENCODE(bits, digits);
-  CUTOFF(32,  1, -10);
-  CUTOFF(32,  2, -100);
-  CUTOFF(32,  3, -1000);
-  CUTOFF(32,  4, -10000);
-  CUTOFF(32,  5, -100000);
-  CUTOFF(32,  6, -1000000);
-  CUTOFF(32,  7, -10000000);
-  CUTOFF(32,  8, -100000000);
-  CUTOFF(32,  9, -1000000000);
-  ENCODE(32, 10);
-  #undef CUTOFF
-  #undef ENCODE
+  const auto p = context.reserve(11);  // '-' and 10 digits for INT32_MIN
+  p[0] = '-';
+  const auto magnitude = static_cast<uint32_t>(0 - static_cast<uint32_t>(value));
+  context.advance(1 + write_integer_32(p + 1, magnitude));
 }
 
 void encode_negative_integer_64(encode_context &context, int64_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = int_fast ## bits ## _t; \
-    return negative<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value > cutoff ## LL) ENCODE(bits, digits);
-  CUTOFF(32,  1, -10);
-  CUTOFF(32,  2, -100);
-  CUTOFF(32,  3, -1000);
-  CUTOFF(32,  4, -10000);
-  CUTOFF(32,  5, -100000);
-  CUTOFF(32,  6, -1000000);
-  CUTOFF(32,  7, -10000000);
-  CUTOFF(32,  8, -100000000);
-  CUTOFF(32,  9, -1000000000);
-  CUTOFF(64, 10, -10000000000);
-  CUTOFF(64, 11, -100000000000);
-  CUTOFF(64, 12, -1000000000000);
-  CUTOFF(64, 13, -10000000000000);
-  CUTOFF(64, 14, -100000000000000);
-  CUTOFF(64, 15, -1000000000000000);
-  CUTOFF(64, 16, -10000000000000000);
-  CUTOFF(64, 17, -100000000000000000);
-  CUTOFF(64, 18, -1000000000000000000);
-  ENCODE(64, 19);
-  #undef CUTOFF
-  #undef ENCODE
+  const auto p = context.reserve(21);  // '-' and 20 bytes of scratch space for 19 digits
+  p[0] = '-';
+  const auto magnitude = static_cast<uint64_t>(0 - static_cast<uint64_t>(value));
+  context.advance(1 + write_integer_64(p + 1, magnitude));
 }
 
 void encode_positive_integer_32(encode_context &context, uint32_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = uint_fast ## bits ## _t; \
-    return positive<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value < cutoff ## UL) ENCODE(bits, digits);
-  CUTOFF(32,  1, 10);
-  CUTOFF(32,  2, 100);
-  CUTOFF(32,  3, 1000);
-  CUTOFF(32,  4, 10000);
-  CUTOFF(32,  5, 100000);
-  CUTOFF(32,  6, 1000000);
-  CUTOFF(32,  7, 10000000);
-  CUTOFF(32,  8, 100000000);
-  CUTOFF(32,  9, 1000000000);
-  ENCODE(32, 10);
-  #undef CUTOFF
-  #undef ENCODE
+  context.advance(write_integer_32(context.reserve(10), value));
 }
 
 void encode_positive_integer_64(encode_context &context, uint64_t value) {
-  #define ENCODE(bits, digits) do { \
-    using type = uint_fast ## bits ## _t; \
-    return positive<type, digits>::encode(context, type(value)); \
-  } while (false)
-  #define CUTOFF(bits, digits, cutoff) if (value < cutoff ## ULL) ENCODE(bits, digits);
-  CUTOFF(32,  1, 10);
-  CUTOFF(32,  2, 100);
-  CUTOFF(32,  3, 1000);
-  CUTOFF(32,  4, 10000);
-  CUTOFF(32,  5, 100000);
-  CUTOFF(32,  6, 1000000);
-  CUTOFF(32,  7, 10000000);
-  CUTOFF(32,  8, 100000000);
-  CUTOFF(32,  9, 1000000000);
-  CUTOFF(64, 10, 10000000000);
-  CUTOFF(64, 11, 100000000000);
-  CUTOFF(64, 12, 1000000000000);
-  CUTOFF(64, 13, 10000000000000);
-  CUTOFF(64, 14, 100000000000000);
-  CUTOFF(64, 15, 1000000000000000);
-  CUTOFF(64, 16, 10000000000000000);
-  CUTOFF(64, 17, 100000000000000000);
-  CUTOFF(64, 18, 1000000000000000000);
-  CUTOFF(64, 19, 10000000000000000000);
-  ENCODE(64, 20);
-  #undef CUTOFF
-  #undef ENCODE
+  context.advance(write_integer_64(context.reserve(20), value));
+}
+
+unsigned count_integer_digits(const uint64_t value) {
+  return count_digits(value);
 }
 
 }  // namespace detail
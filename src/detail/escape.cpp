@@ -16,14 +16,30 @@
 
 #include <spotify/json/detail/escape.hpp>
 
+#include <cstdint>
 #include <cstring>
 
+#include <spotify/json/encode_exception.hpp>
+#include <spotify/json/detail/utf8.hpp>
+
 #include "escape_common.hpp"
 
 namespace spotify {
 namespace json {
 namespace detail {
 
+char *reserve_escaped(encode_context &context, const size_t size) {
+  return context.reserve(size);
+}
+
+void append_unescaped(encode_context &context, const char *data, const size_t size) {
+  context.append(data, size);
+}
+
+void fail_invalid_utf8() {
+  throw encode_exception("Invalid UTF-8 in string");
+}
+
 void write_escaped_scalar(
     encode_context &context,
     const char *begin,
@@ -42,6 +58,61 @@ void write_escaped_scalar(
   context.advance(ptr - buf);
 }
 
+void write_escaped_utf8_scalar(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  if (json_unlikely(find_invalid_utf8(begin, end) != end)) {
+    fail_invalid_utf8();
+  }
+  simd().write_escaped(context, begin, end);
+}
+
+namespace {
+
+/**
+ * The number of bytes that write_escaped_c(...) writes for 'c', less one. It
+ * makes the same checks: one extra byte for \", \\ and the popular control
+ * characters (\b, \t, \n, \f, \r), and five for the \u00xx escapes.
+ */
+json_force_inline size_t escaped_size_c(const char c) {
+  const auto u = static_cast<uint8_t>(c);
+  if (json_likely(u >= 0x30)) {
+    return (c == '\\');
+  } else if (json_likely(u >= 0x20)) {
+    return (c == '"');
+  } else {
+    const auto is_popular = (c == '\b' || c == '\t' || c == '\n' || c == '\f' || c == '\r');
+    return (is_popular ? 1 : 5);
+  }
+}
+
+}  // namespace
+
+size_t escaped_size(const char *begin, const char *end) {
+  auto size = static_cast<size_t>(end - begin);
+
+  // Most strings have nothing to escape, so check eight characters at a time
+  // and only look at them one by one if any of them has to be escaped.
+  for (; end - begin >= 8; begin += 8) {
+    uint64_t chunk;
+    std::memcpy(&chunk, begin, sizeof(chunk));
+    const auto has_control_character = ((chunk - 0x2020202020202020ULL) & ~chunk & 0x8080808080808080ULL);
+    if (json_likely(!(has_control_character | json_haschar_8(chunk, '"') | json_haschar_8(chunk, '\\')))) {
+      continue;
+    }
+    for (int i = 0; i < 8; i++) {
+      size += escaped_size_c(begin[i]);
+    }
+  }
+
+  for (; begin != end; ++begin) {
+    size += escaped_size_c(*begin);
+  }
+
+  return size;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/escape.hpp>
+
+#if defined(json_arch_x86)
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "bits_common.hpp"
+#include "escape_common.hpp"
+#include "utf8_avx2.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * A mask of the characters in the chunk that need escaping: control characters
+ * (0x00 through 0x1F), quotation marks and backslashes. There is no unsigned
+ * byte comparison, so a character is a control character if it is unchanged
+ * by an unsigned minimum with 0x1F.
+ */
+json_force_inline uint32_t needs_escaping(const __m256i chunk) {
+  const auto control_characters_last = _mm256_set1_epi8(0x1F);
+  const auto is_control_character = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control_characters_last), chunk);
+  const auto is_quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+  const auto is_backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(
+      _mm256_or_si256(is_control_character, _mm256_or_si256(is_quote, is_backslash))));
+}
+
+/**
+ * Copy the last (less than 32) characters of the input into a block, so that
+ * they can be loaded and classified like a full chunk. Returns a mask of the
+ * characters that need escaping.
+ */
+json_force_inline uint32_t load_tail(char *block, const char *begin, const char *end) {
+  const auto size = static_cast<size_t>(end - begin);
+  std::memcpy(block, begin, size);
+  const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+  return needs_escaping(chunk) & ((uint32_t(1) << size) - 1);
+}
+
+/**
+ * The first character in [begin, end) that needs escaping, or end. When UTF-8
+ * is validated, all of the characters are passed through the validator, not
+ * only the ones before the first character that needs escaping.
+ */
+template <bool validate_utf8>
+json_force_inline const char *find_escaped(
+    const char *begin,
+    const char *end,
+    utf8_validator_avx2 &utf8) {
+  auto escaped = end;
+  for (; end - begin >= 32; begin += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    const auto mask = needs_escaping(chunk);
+    if (validate_utf8) {
+      utf8.check(chunk);
+      if (mask && escaped == end) {
+        escaped = begin + count_trailing_zeros(mask);
+      }
+    } else if (mask) {
+      return begin + count_trailing_zeros(mask);
+    }
+  }
+
+  // The validator must see the end of the string, even if it is at the start
+  // of a chunk, to detect a sequence that is cut short.
+  if (begin < end || validate_utf8) {
+    alignas(32) char block[32] = {};
+    if (begin < end) {
+      std::memcpy(block, begin, end - begin);
+    }
+    const auto chunk = _mm256_load_si256(reinterpret_cast<const __m256i *>(block));
+    const auto mask = needs_escaping(chunk) & ((uint32_t(1) << (end - begin)) - 1);
+    if (validate_utf8) {
+      utf8.check(chunk);
+    }
+    if (mask && escaped == end) {
+      escaped = begin + count_trailing_zeros(mask);
+    }
+  }
+
+  return escaped;
+}
+
+template <bool validate_utf8>
+json_force_inline void write_escaped_kernel(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  // Most strings have nothing to escape. Find the first character that does,
+  // copy everything before it at once, and only reserve space for the worst
+  // case (6 is the length of \u00xx) for the rest.
+  utf8_validator_avx2 utf8;
+  const auto escaped_begin = find_escaped<validate_utf8>(begin, end, utf8);
+  if (validate_utf8 && json_unlikely(utf8.has_error())) {
+    fail_invalid_utf8();
+  }
+
+  const auto clean_size = static_cast<size_t>(escaped_begin - begin);
+  if (json_likely(escaped_begin == end)) {
+    append_unescaped(context, begin, clean_size);
+    return;
+  }
+
+  const auto buf = reserve_escaped(context, clean_size + 6 * (end - escaped_begin) + 32);
+  std::memcpy(buf, begin, clean_size);
+  auto out = buf + clean_size;
+  begin = escaped_begin;
+
+  alignas(32) char block[64];
+  for (; end - begin >= 32; begin += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    const auto mask = needs_escaping(chunk);
+    if (json_likely(!mask)) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), chunk);
+      out += 32;
+    } else {
+      _mm256_store_si256(reinterpret_cast<__m256i *>(block), chunk);
+      write_escaped_block<32>(out, block, 32, mask);
+    }
+  }
+
+  if (begin < end) {
+    const auto mask = load_tail(block, begin, end);
+    write_escaped_block<32>(out, block, end - begin, mask);
+  }
+
+  context.advance(out - buf);
+}
+
+}  // namespace
+
+void write_escaped_avx2(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  write_escaped_kernel<false>(context, begin, end);
+}
+
+void write_escaped_utf8_avx2(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  write_escaped_kernel<true>(context, begin, end);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86)
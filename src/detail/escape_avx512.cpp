@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/escape.hpp>
+
+#if defined(json_simd_avx512)
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "bits_common.hpp"
+#include "escape_common.hpp"
+#include "utf8_avx512.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * A mask of the characters in the chunk that need escaping: control characters
+ * (0x00 through 0x1F), quotation marks and backslashes.
+ */
+json_force_inline uint64_t needs_escaping(const __m512i chunk) {
+  return uint64_t(
+      _mm512_cmple_epu8_mask(chunk, _mm512_set1_epi8(0x1F)) |
+      _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"')) |
+      _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\')));
+}
+
+/**
+ * See tail_mask(...) in skip_chars_avx512.cpp.
+ */
+json_force_inline __mmask64 tail_mask(const char *pos, const char *end) {
+  return __mmask64(~uint64_t(0) >> (64 - (end - pos)));
+}
+
+/**
+ * See find_escaped(...) in escape_avx2.cpp.
+ */
+template <bool validate_utf8>
+json_force_inline const char *find_escaped(
+    const char *begin,
+    const char *end,
+    utf8_validator_avx512 &utf8) {
+  auto escaped = end;
+  for (; end - begin >= 64; begin += 64) {
+    const auto chunk = _mm512_loadu_si512(begin);
+    const auto mask = needs_escaping(chunk);
+    if (validate_utf8) {
+      utf8.check(chunk);
+      if (mask && escaped == end) {
+        escaped = begin + count_trailing_zeros(mask);
+      }
+    } else if (mask) {
+      return begin + count_trailing_zeros(mask);
+    }
+  }
+
+  if (begin < end || validate_utf8) {
+    const auto valid = (begin < end ? tail_mask(begin, end) : __mmask64(0));
+    const auto chunk = _mm512_maskz_loadu_epi8(valid, begin);
+    const auto mask = needs_escaping(chunk) & uint64_t(valid);
+    if (validate_utf8) {
+      utf8.check(chunk);
+    }
+    if (mask && escaped == end) {
+      escaped = begin + count_trailing_zeros(mask);
+    }
+  }
+
+  return escaped;
+}
+
+template <bool validate_utf8>
+json_force_inline void write_escaped_kernel(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  // See write_escaped_kernel(...) in escape_avx2.cpp.
+  utf8_validator_avx512 utf8;
+  const auto escaped_begin = find_escaped<validate_utf8>(begin, end, utf8);
+  if (validate_utf8 && json_unlikely(utf8.has_error())) {
+    fail_invalid_utf8();
+  }
+
+  const auto clean_size = static_cast<size_t>(escaped_begin - begin);
+  if (json_likely(escaped_begin == end)) {
+    append_unescaped(context, begin, clean_size);
+    return;
+  }
+
+  const auto buf = reserve_escaped(context, clean_size + 6 * (end - escaped_begin) + 64);
+  std::memcpy(buf, begin, clean_size);
+  auto out = buf + clean_size;
+  begin = escaped_begin;
+
+  alignas(64) char block[128];
+  for (; end - begin >= 64; begin += 64) {
+    const auto chunk = _mm512_loadu_si512(begin);
+    const auto mask = needs_escaping(chunk);
+    if (json_likely(!mask)) {
+      _mm512_storeu_si512(out, chunk);
+      out += 64;
+    } else {
+      _mm512_store_si512(block, chunk);
+      write_escaped_block<64>(out, block, 64, mask);
+    }
+  }
+
+  if (begin < end) {
+    const auto valid = tail_mask(begin, end);
+    const auto chunk = _mm512_maskz_loadu_epi8(valid, begin);
+    _mm512_store_si512(block, chunk);
+    write_escaped_block<64>(out, block, end - begin, needs_escaping(chunk) & uint64_t(valid));
+  }
+
+  context.advance(out - buf);
+}
+
+}  // namespace
+
+void write_escaped_avx512(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  write_escaped_kernel<false>(context, begin, end);
+}
+
+void write_escaped_utf8_avx512(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  write_escaped_kernel<true>(context, begin, end);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_simd_avx512)
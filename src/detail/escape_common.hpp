@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
+#include "bits_common.hpp"
 
 #if _MSC_VER
 #pragma intrinsic (memcpy)
@@ -29,6 +33,17 @@ namespace spotify {
 namespace json {
 namespace detail {
 
+/**
+ * context.reserve(...) and context.append(...), and throwing for invalid UTF-8,
+ * compiled in escape.cpp. The kernels that are compiled for a particular
+ * instruction set call these instead, so that they do not emit copies of the
+ * inline encode_context and encode_exception code, such as grow_buffer(...),
+ * that the linker could then pick for the whole program.
+ */
+json_never_inline char *reserve_escaped(encode_context &context, size_t size);
+json_never_inline void append_unescaped(encode_context &context, const char *data, size_t size);
+json_never_inline json_noreturn void fail_invalid_utf8();
+
 json_force_inline void write_escaped_c(char *&out, const char c) {
   static const char HEX[] = "0123456789ABCDEF";
   static const char POPULAR_CONTROL_CHARACTERS[] = {
@@ -122,6 +137,32 @@ json_force_inline void write_escaped_8(char *&out, const char *&begin) {
   begin += sizeof(blob_8_t);
 }
 
+/**
+ * Write the first 'size' characters of 'block' escaped, given a mask with a bit
+ * set for each of them that needs escaping. The runs of characters in between
+ * are copied with fixed size copies of 'block_size' bytes, so 'block' must be
+ * readable for 2 * block_size bytes, and there must be room for block_size
+ * bytes more than what is written at 'out'.
+ */
+template <std::size_t block_size, typename mask_type>
+json_force_inline void write_escaped_block(
+    char *&out,
+    const char *block,
+    const std::size_t size,
+    mask_type mask) {
+  std::size_t pos = 0;
+  while (mask) {
+    const auto i = count_trailing_zeros(mask);
+    std::memcpy(out, block + pos, block_size);
+    out += i - pos;
+    write_escaped_c(out, block[i]);
+    pos = i + 1;
+    mask &= mask - 1;
+  }
+  std::memcpy(out, block + pos, block_size);
+  out += size - pos;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
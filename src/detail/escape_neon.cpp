@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/escape.hpp>
+
+#if defined(json_arch_arm64)
+
+#include <arm_neon.h>
+
+#include "escape_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+void write_escaped_neon(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  const auto buf = reserve_escaped(context, 6 * (end - begin));  // 6 is the length of \u00xx
+  auto out = buf;
+
+  const auto control_characters_end = vdupq_n_u8(0x20);
+  const auto quote = vdupq_n_u8('"');
+  const auto backslash = vdupq_n_u8('\\');
+
+  while (end - begin >= 16) {
+    const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(begin));
+    const auto is_control_character = vcltq_u8(chunk, control_characters_end);
+    const auto is_quote = vceqq_u8(chunk, quote);
+    const auto is_backslash = vceqq_u8(chunk, backslash);
+    const auto needs_escaping = vorrq_u8(is_control_character, vorrq_u8(is_quote, is_backslash));
+    if (json_likely(!vmaxvq_u8(needs_escaping))) {
+      vst1q_u8(reinterpret_cast<uint8_t *>(out), chunk);
+      out += 16;
+      begin += 16;
+    } else {
+      write_escaped_8(out, begin);
+      write_escaped_8(out, begin);
+    }
+  }
+
+  if ((end - begin) >= 8) { write_escaped_8(out, begin); }
+  if ((end - begin) >= 4) { write_escaped_4(out, begin); }
+  if ((end - begin) >= 2) { write_escaped_2(out, begin); }
+  if ((end - begin) >= 1) { write_escaped_1(out, begin); }
+
+  context.advance(out - buf);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_arm64)
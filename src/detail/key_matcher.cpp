@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/key_matcher.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const size_t key_matcher::npos;
+
+bool key_matcher::insert(const std::string &key) {
+  if (find(key.data(), key.data() + key.size()) != npos) {
+    return false;
+  }
+
+  _keys.push_back(key);
+  if (_keys.size() * 2 > _slots.size()) {
+    rehash(_slots.size() * 4);
+  } else {
+    place(_keys.size() - 1);
+  }
+
+  return true;
+}
+
+void key_matcher::rehash(const size_t num_slots) {
+  _slots.assign(num_slots, 0);
+  _mask = num_slots - 1;
+  for (size_t i = 0; i < _keys.size(); i++) {
+    place(i);
+  }
+}
+
+void key_matcher::place(const size_t index) {
+  const auto &key = _keys[index];
+  auto slot = hash(key.data(), key.size()) & _mask;
+  while (_slots[slot]) {
+    slot = (slot + 1) & _mask;
+  }
+  _slots[slot] = static_cast<uint32_t>(index + 1);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/simd_dispatch.hpp>
+
+#include <spotify/json/detail/cpuid.hpp>
+#include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+simd_dispatch resolve_simd_dispatch() {
+  simd_dispatch dispatch;
+  dispatch.skip_any_simple_characters = &skip_any_simple_characters_scalar;
+  dispatch.skip_any_simple_characters_utf8 = &skip_any_simple_characters_utf8_scalar;
+  dispatch.skip_any_whitespace = &skip_any_whitespace_scalar;
+  dispatch.write_escaped = &write_escaped_scalar;
+  dispatch.write_escaped_utf8 = &write_escaped_utf8_scalar;
+
+  // Each instruction set supersedes the ones checked before it, so the widest
+  // kernel that the CPU supports is the one that ends up in the table.
+  const cpuid cpu;
+
+#if defined(json_arch_x86)
+  if (cpu.has_sse2()) {
+    dispatch.skip_any_simple_characters = &skip_any_simple_characters_sse2;
+    dispatch.skip_any_whitespace = &skip_any_whitespace_sse2;
+  }
+
+  if (cpu.has_sse42()) {
+    dispatch.skip_any_simple_characters = &skip_any_simple_characters_sse42;
+    dispatch.skip_any_whitespace = &skip_any_whitespace_sse42;
+    dispatch.write_escaped = &write_escaped_sse42;
+  }
+
+  if (cpu.has_avx2()) {
+    dispatch.skip_any_simple_characters = &skip_any_simple_characters_avx2;
+    dispatch.skip_any_simple_characters_utf8 = &skip_any_simple_characters_utf8_avx2;
+    dispatch.skip_any_whitespace = &skip_any_whitespace_avx2;
+    dispatch.write_escaped = &write_escaped_avx2;
+    dispatch.write_escaped_utf8 = &write_escaped_utf8_avx2;
+  }
+
+#if defined(json_simd_avx512)
+  if (cpu.has_avx512bw()) {
+    dispatch.skip_any_simple_characters = &skip_any_simple_characters_avx512;
+    dispatch.skip_any_simple_characters_utf8 = &skip_any_simple_characters_utf8_avx512;
+    dispatch.skip_any_whitespace = &skip_any_whitespace_avx512;
+    dispatch.write_escaped = &write_escaped_avx512;
+    dispatch.write_escaped_utf8 = &write_escaped_utf8_avx512;
+  }
+#endif  // defined(json_simd_avx512)
+#endif  // defined(json_arch_x86)
+
+#if defined(json_arch_arm64)
+  if (cpu.has_neon()) {
+    dispatch.skip_any_simple_characters = &skip_any_simple_characters_neon;
+    dispatch.skip_any_whitespace = &skip_any_whitespace_neon;
+    dispatch.write_escaped = &write_escaped_neon;
+  }
+#endif  // defined(json_arch_arm64)
+
+  return dispatch;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -16,7 +16,9 @@
 
 #include <spotify/json/detail/skip_chars.hpp>
 
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/utf8.hpp>
 
 #include "skip_chars_common.hpp"
 
@@ -37,6 +39,14 @@ void skip_any_simple_characters_scalar(decode_context &context) {
   done_x: context.position = pos;
 }
 
+void skip_any_simple_characters_utf8_scalar(decode_context &context) {
+  const auto begin = context.position;
+  simd().skip_any_simple_characters(context);
+  if (json_unlikely(find_invalid_utf8(begin, context.position) != context.position)) {
+    fail_invalid_utf8(context, begin);
+  }
+}
+
 void skip_any_whitespace_scalar(decode_context &context) {
   const auto end = context.end;
   auto pos = context.position;
@@ -46,6 +56,11 @@ void skip_any_whitespace_scalar(decode_context &context) {
   context.position = pos;
 }
 
+void fail_invalid_utf8(const decode_context &context, const char *begin) {
+  const auto invalid = find_invalid_utf8(begin, context.position);
+  fail(context, "Invalid UTF-8 in string", invalid - context.position);
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/skip_chars.hpp>
+
+#if defined(json_arch_x86)
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "bits_common.hpp"
+#include "skip_chars_common.hpp"
+#include "utf8_avx2.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * Lookup table for classifying whitespace with a single byte shuffle. The four
+ * whitespace characters have distinct low nibbles, so each one is stored at the
+ * index of its low nibble. A byte is whitespace if and only if looking up its
+ * low nibble in the table yields the byte itself. All other entries have the
+ * high bit set, which no byte with a matching low nibble can equal (the shuffle
+ * returns zero for bytes that have the high bit set).
+ */
+json_force_inline __m256i whitespace_table() {
+  const char x = static_cast<char>(0x80);
+  return _mm256_setr_epi8(
+      ' ', x, x, x, x, x, x, x, x, '\t', '\n', x, x, '\r', x, x,
+      ' ', x, x, x, x, x, x, x, x, '\t', '\n', x, x, '\r', x, x);
+}
+
+/**
+ * The first 'size' bytes of the chunk, followed by zeros.
+ */
+json_force_inline __m256i keep_first(const __m256i chunk, const unsigned size) {
+  const auto index = _mm256_setr_epi8(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+      16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+  return _mm256_and_si256(chunk, _mm256_cmpgt_epi8(_mm256_set1_epi8(char(size)), index));
+}
+
+}  // namespace
+
+void skip_any_simple_characters_avx2(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm256_set1_epi8('"');
+  const auto backslash = _mm256_set1_epi8('\\');
+
+  for (; end - pos >= 32; pos += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto is_quote = _mm256_cmpeq_epi8(chunk, quote);
+    const auto is_backslash = _mm256_cmpeq_epi8(chunk, backslash);
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_quote, is_backslash)));
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+  if (end - pos >= 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto is_quote = _mm_cmpeq_epi8(chunk, _mm256_castsi256_si128(quote));
+    const auto is_backslash = _mm_cmpeq_epi8(chunk, _mm256_castsi256_si128(backslash));
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(is_quote, is_backslash)));
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+    pos += 16;
+  }
+
+          JSON_STRING_SKIP_N_SIMPLE(8, x, uint64_t, while, done_8)
+  done_8: JSON_STRING_SKIP_N_SIMPLE(4, x, uint32_t, while, done_4)
+  done_4: JSON_STRING_SKIP_N_SIMPLE(2, x, uint16_t, while, done_2)
+  done_2: JSON_STRING_SKIP_N_SIMPLE(1, x, uint8_t,  while, done_x)
+  done_x: context.position = pos;
+}
+
+void skip_any_simple_characters_utf8_avx2(decode_context &context) {
+  const auto begin = context.position;
+  const auto end = context.end;
+  auto pos = begin;
+
+  const auto quote = _mm256_set1_epi8('"');
+  const auto backslash = _mm256_set1_epi8('\\');
+
+  utf8_validator_avx2 utf8;
+  auto chunk = _mm256_setzero_si256();
+  auto mask = uint32_t(0);
+
+  for (; end - pos >= 32; pos += 32) {
+    chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto is_quote = _mm256_cmpeq_epi8(chunk, quote);
+    const auto is_backslash = _mm256_cmpeq_epi8(chunk, backslash);
+    mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_quote, is_backslash)));
+    if (mask) {
+      break;
+    }
+    utf8.check(chunk);
+  }
+
+  // Handle the tail like a full chunk that is padded with zeros. The chunk with
+  // the end of the string is always validated, also when the string ends right
+  // at the start of it, since that is where a truncated sequence is detected.
+  if (!mask) {
+    alignas(32) char block[32] = {};
+    std::memcpy(block, pos, end - pos);
+    chunk = _mm256_load_si256(reinterpret_cast<const __m256i *>(block));
+    const auto is_quote = _mm256_cmpeq_epi8(chunk, quote);
+    const auto is_backslash = _mm256_cmpeq_epi8(chunk, backslash);
+    mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_quote, is_backslash)));
+  }
+
+  const auto size = (mask ? count_trailing_zeros(mask) : static_cast<unsigned>(end - pos));
+  utf8.check(keep_first(chunk, size));
+  context.position = pos + size;
+  if (json_unlikely(utf8.has_error())) {
+    fail_invalid_utf8(context, begin);
+  }
+}
+
+void skip_any_whitespace_avx2(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto table = whitespace_table();
+
+  for (; end - pos >= 32; pos += 32) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    const auto is_whitespace = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(table, chunk), chunk);
+    const auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(is_whitespace));
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+  if (end - pos >= 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto lookup = _mm_shuffle_epi8(_mm256_castsi256_si128(table), chunk);
+    const auto is_whitespace = _mm_cmpeq_epi8(lookup, chunk);
+    const auto mask = static_cast<uint32_t>(~_mm_movemask_epi8(is_whitespace)) & 0xFFFF;
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+    pos += 16;
+  }
+
+  while (pos < end && is_space(*pos)) {
+    ++pos;
+  }
+
+  context.position = pos;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86)
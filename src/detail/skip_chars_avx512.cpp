@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/skip_chars.hpp>
+
+#if defined(json_simd_avx512)
+
+#include <immintrin.h>
+
+#include "bits_common.hpp"
+#include "skip_chars_common.hpp"
+#include "utf8_avx512.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * See whitespace_table() in skip_chars_avx2.cpp.
+ */
+json_force_inline __m512i whitespace_table() {
+  const char x = static_cast<char>(0x80);
+  return _mm512_broadcast_i32x4(_mm_setr_epi8(
+      ' ', x, x, x, x, x, x, x, x, '\t', '\n', x, x, '\r', x, x));
+}
+
+/**
+ * A mask of the bytes in [pos, end), for when there are less than 64 of them.
+ * Masked loads do not touch the bytes outside of the mask, so this lets us deal
+ * with the tail of the input without falling back to a scalar loop.
+ */
+json_force_inline __mmask64 tail_mask(const char *pos, const char *end) {
+  return __mmask64(~uint64_t(0) >> (64 - (end - pos)));
+}
+
+/**
+ * A mask of the bytes before the first one that is set in the (non-zero) mask.
+ */
+json_force_inline __mmask64 bytes_before(const uint64_t mask) {
+  return __mmask64((mask - 1) & ~mask);
+}
+
+}  // namespace
+
+void skip_any_simple_characters_avx512(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm512_set1_epi8('"');
+  const auto backslash = _mm512_set1_epi8('\\');
+
+  for (; end - pos >= 64; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto mask = uint64_t(
+        _mm512_cmpeq_epi8_mask(chunk, quote) |
+        _mm512_cmpeq_epi8_mask(chunk, backslash));
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+  if (pos < end) {
+    const auto valid = tail_mask(pos, end);
+    const auto chunk = _mm512_maskz_loadu_epi8(valid, pos);
+    const auto mask = uint64_t(
+        _mm512_mask_cmpeq_epi8_mask(valid, chunk, quote) |
+        _mm512_mask_cmpeq_epi8_mask(valid, chunk, backslash));
+    pos = (mask ? pos + count_trailing_zeros(mask) : end);
+  }
+
+  context.position = pos;
+}
+
+void skip_any_simple_characters_utf8_avx512(decode_context &context) {
+  const auto begin = context.position;
+  const auto end = context.end;
+  auto pos = begin;
+
+  const auto quote = _mm512_set1_epi8('"');
+  const auto backslash = _mm512_set1_epi8('\\');
+
+  utf8_validator_avx512 utf8;
+
+  for (; end - pos >= 64; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto mask = uint64_t(
+        _mm512_cmpeq_epi8_mask(chunk, quote) |
+        _mm512_cmpeq_epi8_mask(chunk, backslash));
+    if (mask) {
+      const auto size = count_trailing_zeros(mask);
+      utf8.check(_mm512_maskz_mov_epi8(bytes_before(mask), chunk));
+      context.position = pos + size;
+      if (json_unlikely(utf8.has_error())) {
+        fail_invalid_utf8(context, begin);
+      }
+      return;
+    }
+    utf8.check(chunk);
+  }
+
+  // See skip_any_simple_characters_utf8_avx2(...). The masked load leaves the
+  // bytes after the end of the input zero.
+  const auto valid = (pos < end ? tail_mask(pos, end) : __mmask64(0));
+  const auto chunk = _mm512_maskz_loadu_epi8(valid, pos);
+  const auto mask = uint64_t(
+      _mm512_mask_cmpeq_epi8_mask(valid, chunk, quote) |
+      _mm512_mask_cmpeq_epi8_mask(valid, chunk, backslash));
+  const auto size = (mask ? count_trailing_zeros(mask) : static_cast<unsigned>(end - pos));
+  utf8.check(_mm512_maskz_mov_epi8(mask ? bytes_before(mask) : valid, chunk));
+  context.position = pos + size;
+  if (json_unlikely(utf8.has_error())) {
+    fail_invalid_utf8(context, begin);
+  }
+}
+
+void skip_any_whitespace_avx512(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto table = whitespace_table();
+
+  for (; end - pos >= 64; pos += 64) {
+    const auto chunk = _mm512_loadu_si512(pos);
+    const auto lookup = _mm512_shuffle_epi8(table, chunk);
+    const auto mask = ~uint64_t(_mm512_cmpeq_epi8_mask(lookup, chunk));
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+  if (pos < end) {
+    const auto valid = tail_mask(pos, end);
+    const auto chunk = _mm512_maskz_loadu_epi8(valid, pos);
+    const auto lookup = _mm512_shuffle_epi8(table, chunk);
+    const auto mask = ~uint64_t(_mm512_cmpeq_epi8_mask(lookup, chunk)) & uint64_t(valid);
+    pos = (mask ? pos + count_trailing_zeros(mask) : end);
+  }
+
+  context.position = pos;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_simd_avx512)
@@ -14,6 +14,7 @@
  * the License.
  */
 
+#include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/macros.hpp>
 
 #define json_unaligned_x(ignore) true
@@ -34,6 +35,12 @@ json_force_inline bool is_space(const char c) {
   return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
 }
 
+/**
+ * Fail at the first invalid UTF-8 sequence in [begin, context.position). This
+ * is used by the validating kernels, which only know that there is one.
+ */
+json_noreturn void fail_invalid_utf8(const decode_context &context, const char *begin);
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/skip_chars.hpp>
+
+#if defined(json_arch_arm64)
+
+#include <arm_neon.h>
+
+#include "bits_common.hpp"
+#include "skip_chars_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * NEON has no movemask instruction. Narrowing each 16-bit lane by four bits
+ * turns a byte comparison result into a 64-bit mask with four bits per byte,
+ * which is just as good for finding the index of the first matching byte.
+ */
+json_force_inline uint64_t nibble_mask(const uint8x16_t matches) {
+  const auto narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+/**
+ * See whitespace_table() in skip_chars_avx2.cpp. Unlike pshufb, tbl yields
+ * zero for out of range indices instead of looking at the low nibble, so the
+ * lookup needs to mask out the high nibble first.
+ */
+json_force_inline uint8x16_t whitespace_table() {
+  static const uint8_t TABLE[16] = {
+    ' ', 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, '\t', '\n', 0x80, 0x80, '\r', 0x80, 0x80
+  };
+  return vld1q_u8(TABLE);
+}
+
+}  // namespace
+
+void skip_any_simple_characters_neon(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = vdupq_n_u8('"');
+  const auto backslash = vdupq_n_u8('\\');
+
+  for (; end - pos >= 16; pos += 16) {
+    const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(pos));
+    const auto is_quote = vceqq_u8(chunk, quote);
+    const auto is_backslash = vceqq_u8(chunk, backslash);
+    const auto mask = nibble_mask(vorrq_u8(is_quote, is_backslash));
+    if (mask) {
+      context.position = pos + (count_trailing_zeros(mask) >> 2);
+      return;
+    }
+  }
+
+          JSON_STRING_SKIP_N_SIMPLE(8, x, uint64_t, while, done_8)
+  done_8: JSON_STRING_SKIP_N_SIMPLE(4, x, uint32_t, while, done_4)
+  done_4: JSON_STRING_SKIP_N_SIMPLE(2, x, uint16_t, while, done_2)
+  done_2: JSON_STRING_SKIP_N_SIMPLE(1, x, uint8_t,  while, done_x)
+  done_x: context.position = pos;
+}
+
+void skip_any_whitespace_neon(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto table = whitespace_table();
+  const auto low_nibble = vdupq_n_u8(0x0F);
+
+  for (; end - pos >= 16; pos += 16) {
+    const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(pos));
+    const auto lookup = vqtbl1q_u8(table, vandq_u8(chunk, low_nibble));
+    const auto is_not_whitespace = vmvnq_u8(vceqq_u8(lookup, chunk));
+    const auto mask = nibble_mask(is_not_whitespace);
+    if (mask) {
+      context.position = pos + (count_trailing_zeros(mask) >> 2);
+      return;
+    }
+  }
+
+  while (pos < end && is_space(*pos)) {
+    ++pos;
+  }
+
+  context.position = pos;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_arm64)
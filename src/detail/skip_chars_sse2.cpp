@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/skip_chars.hpp>
+
+#if defined(json_arch_x86)
+
+#include <emmintrin.h>
+
+#include "bits_common.hpp"
+#include "skip_chars_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+void skip_any_simple_characters_sse2(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+
+  for (; end - pos >= 16; pos += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto is_quote = _mm_cmpeq_epi8(chunk, quote);
+    const auto is_backslash = _mm_cmpeq_epi8(chunk, backslash);
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(is_quote, is_backslash)));
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+          JSON_STRING_SKIP_N_SIMPLE(8, x, uint64_t, while, done_8)
+  done_8: JSON_STRING_SKIP_N_SIMPLE(4, x, uint32_t, while, done_4)
+  done_4: JSON_STRING_SKIP_N_SIMPLE(2, x, uint16_t, while, done_2)
+  done_2: JSON_STRING_SKIP_N_SIMPLE(1, x, uint8_t,  while, done_x)
+  done_x: context.position = pos;
+}
+
+void skip_any_whitespace_sse2(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+
+  const auto space = _mm_set1_epi8(' ');
+  const auto tab = _mm_set1_epi8('\t');
+  const auto line_feed = _mm_set1_epi8('\n');
+  const auto carriage_return = _mm_set1_epi8('\r');
+
+  for (; end - pos >= 16; pos += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto is_space_or_tab = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab));
+    const auto is_newline = _mm_or_si128(_mm_cmpeq_epi8(chunk, line_feed), _mm_cmpeq_epi8(chunk, carriage_return));
+    const auto is_whitespace = _mm_or_si128(is_space_or_tab, is_newline);
+    const auto mask = static_cast<uint32_t>(~_mm_movemask_epi8(is_whitespace)) & 0xFFFF;
+    if (mask) {
+      context.position = pos + count_trailing_zeros(mask);
+      return;
+    }
+  }
+
+  while (pos < end && is_space(*pos)) {
+    ++pos;
+  }
+
+  context.position = pos;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86)
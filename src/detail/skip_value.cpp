@@ -16,12 +16,16 @@
 
 #include <spotify/json/detail/skip_value.hpp>
 
+#include <cstring>
 #include <limits>
 
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/stack.hpp>
 
+#include "bits_common.hpp"
+#include "structural_common.hpp"
+
 namespace spotify {
 namespace json {
 namespace detail {
@@ -130,9 +134,86 @@ void skip_simple_value(decode_context &context) {
   }
 }
 
-}  // namespace
+/**
+ * Find the end of the object or array that starts at 'begin' by counting the
+ * brackets that are outside of strings, 64 bytes at a time. Strings are found
+ * like when building a structural_index: the quotes that are not escaped mark
+ * the bytes inside of strings by a prefix XOR. The brackets of a block are only
+ * looked at one by one if the closing bracket can be in that block; otherwise
+ * they are just counted. Returns the position after the closing bracket, or
+ * nullptr if the input ends before it.
+ */
+const char *find_container_end(const char *begin, const char *end) {
+  const auto size = static_cast<size_t>(end - begin);
+  uint64_t prev_escaped = 0;
+  uint64_t prev_in_string = 0;
+  size_t depth = 0;
+
+  for (size_t offset = 0; offset < size; offset += 64) {
+    block_masks masks;
+    if (json_likely(size - offset >= 64)) {
+      masks = classify(begin + offset);
+    } else {
+      char padded[64];
+      std::memset(padded, ' ', sizeof(padded));
+      std::memcpy(padded, begin + offset, size - offset);
+      masks = classify(padded);
+    }
 
-void skip_value(decode_context &context) {
+    const auto escaped = find_escaped(masks.backslash, prev_escaped);
+    const auto quote = masks.quote & ~escaped;
+    const auto in_string = prefix_xor(quote) ^ prev_in_string;
+    prev_in_string = uint64_t(0) - (in_string >> 63);
+
+    const auto open = masks.open & ~in_string;
+    const auto close = masks.close & ~in_string;
+    const auto num_close = count_ones(close);
+    if (json_likely(num_close < depth)) {
+      depth = depth + count_ones(open) - num_close;
+      continue;
+    }
+
+    for (auto brackets = open | close; brackets; brackets &= (brackets - 1)) {
+      const auto index = count_trailing_zeros(brackets);
+      if (open & (uint64_t(1) << index)) {
+        depth++;
+      } else if (--depth == 0) {
+        return begin + offset + index + 1;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * If the context is at an object or array, skip past it without checking its
+ * contents, using the structural index if there is one. Returns false if there
+ * is no container to skip or if it does not end, in which case the context has
+ * not moved.
+ */
+json_force_inline bool skip_container_unchecked(decode_context &context) {
+  const auto c = peek(context);
+  if (c != '{' && c != '[') {
+    return false;
+  }
+
+  const auto after = (context.index ?
+      context.index->skip_container(context.position) :
+      find_container_end(context.position, context.end));
+  if (json_unlikely(!after)) {
+    return false;
+  }
+
+  context.position = after;
+  return true;
+}
+
+/**
+ * Skip past one JSON value and check that it follows the JSON grammar, see
+ * skip_value(...).
+ */
+void skip_value_checked(decode_context &context) {
   enum state {
     done = 0,
     want = 1 << 0,
@@ -210,6 +291,28 @@ void skip_value(decode_context &context) {
   fail_if(context, pstate != done, "Unexpected EOF");
 }
 
+}  // namespace
+
+void skip_value(decode_context &context) {
+  // With a structural index, objects and arrays are skipped in one step by
+  // jumping to the matching bracket. With skip_unchecked, the matching bracket
+  // is searched for instead. Neither is done if strings must be validated.
+  const auto unchecked = (context.index || context.skip_unchecked);
+  if (unchecked && !context.validate_utf8 && skip_container_unchecked(context)) {
+    return;
+  }
+
+  skip_value_checked(context);
+}
+
+void skip_value_unchecked(decode_context &context) {
+  if (!context.validate_utf8 && skip_container_unchecked(context)) {
+    return;
+  }
+
+  skip_value_checked(context);
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
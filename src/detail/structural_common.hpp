@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <spotify/json/detail/macros.hpp>
+
+#if defined(json_arch_x86_64)
+#include <emmintrin.h>
+#elif defined(json_arch_arm64)
+#include <arm_neon.h>
+#endif
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Bit masks for one 64 byte block of input, with bit i set if byte i of the
+ * block is of the given class. The structural characters are {}[]:, of which
+ * {[ are also in the open mask and }] in the close mask, but note that they
+ * have not yet been filtered for being inside of strings. The masks that a
+ * caller does not use are optimized away once classify(...) is inlined.
+ */
+struct block_masks {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t open;
+  uint64_t close;
+  uint64_t structural;
+  uint64_t whitespace;
+};
+
+#if defined(json_arch_x86_64)
+
+json_force_inline uint64_t movemask(const __m128i matches, const unsigned chunk) {
+  return uint64_t(uint32_t(_mm_movemask_epi8(matches))) << (16 * chunk);
+}
+
+json_force_inline block_masks classify(const char *block) {
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+  const auto lowercase = _mm_set1_epi8(0x20);  // '[' | 0x20 == '{', ']' | 0x20 == '}'
+  const auto open_brace = _mm_set1_epi8('{');
+  const auto close_brace = _mm_set1_epi8('}');
+  const auto colon = _mm_set1_epi8(':');
+  const auto comma = _mm_set1_epi8(',');
+  const auto space = _mm_set1_epi8(' ');
+  const auto tab = _mm_set1_epi8('\t');
+  const auto line_feed = _mm_set1_epi8('\n');
+  const auto carriage_return = _mm_set1_epi8('\r');
+
+  block_masks masks = { 0, 0, 0, 0, 0, 0 };
+  for (unsigned i = 0; i < 4; i++) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i));
+    const auto lowered = _mm_or_si128(chunk, lowercase);
+    const auto is_open = _mm_cmpeq_epi8(lowered, open_brace);
+    const auto is_close = _mm_cmpeq_epi8(lowered, close_brace);
+    const auto is_bracket = _mm_or_si128(is_open, is_close);
+    const auto is_separator = _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma));
+    const auto is_space_or_tab = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab));
+    const auto is_newline = _mm_or_si128(_mm_cmpeq_epi8(chunk, line_feed), _mm_cmpeq_epi8(chunk, carriage_return));
+    masks.quote |= movemask(_mm_cmpeq_epi8(chunk, quote), i);
+    masks.backslash |= movemask(_mm_cmpeq_epi8(chunk, backslash), i);
+    masks.open |= movemask(is_open, i);
+    masks.close |= movemask(is_close, i);
+    masks.structural |= movemask(_mm_or_si128(is_bracket, is_separator), i);
+    masks.whitespace |= movemask(_mm_or_si128(is_space_or_tab, is_newline), i);
+  }
+  return masks;
+}
+
+#elif defined(json_arch_arm64)
+
+/**
+ * Combine four byte comparison results into one 64-bit mask. Each byte is
+ * reduced to its bit in the mask, and then adjacent bytes are summed up in
+ * three rounds of pairwise additions.
+ */
+json_force_inline uint64_t movemask(
+    const uint8x16_t m0,
+    const uint8x16_t m1,
+    const uint8x16_t m2,
+    const uint8x16_t m3) {
+  static const uint8_t BITS[16] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+  };
+  const auto bits = vld1q_u8(BITS);
+  const auto sum0 = vpaddq_u8(vandq_u8(m0, bits), vandq_u8(m1, bits));
+  const auto sum1 = vpaddq_u8(vandq_u8(m2, bits), vandq_u8(m3, bits));
+  const auto sum2 = vpaddq_u8(sum0, sum1);
+  const auto sum3 = vpaddq_u8(sum2, sum2);
+  return vgetq_lane_u64(vreinterpretq_u64_u8(sum3), 0);
+}
+
+struct chunk_masks {
+  uint8x16_t quote;
+  uint8x16_t backslash;
+  uint8x16_t open;
+  uint8x16_t close;
+  uint8x16_t structural;
+  uint8x16_t whitespace;
+};
+
+json_force_inline chunk_masks classify_chunk(const char *chunk_begin) {
+  const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(chunk_begin));
+  const auto lowered = vorrq_u8(chunk, vdupq_n_u8(0x20));  // '[' | 0x20 == '{', ']' | 0x20 == '}'
+  const auto is_open = vceqq_u8(lowered, vdupq_n_u8('{'));
+  const auto is_close = vceqq_u8(lowered, vdupq_n_u8('}'));
+  const auto is_bracket = vorrq_u8(is_open, is_close);
+  const auto is_separator = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(':')), vceqq_u8(chunk, vdupq_n_u8(',')));
+  const auto is_space_or_tab = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')), vceqq_u8(chunk, vdupq_n_u8('\t')));
+  const auto is_newline = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')), vceqq_u8(chunk, vdupq_n_u8('\r')));
+
+  chunk_masks masks;
+  masks.quote = vceqq_u8(chunk, vdupq_n_u8('"'));
+  masks.backslash = vceqq_u8(chunk, vdupq_n_u8('\\'));
+  masks.open = is_open;
+  masks.close = is_close;
+  masks.structural = vorrq_u8(is_bracket, is_separator);
+  masks.whitespace = vorrq_u8(is_space_or_tab, is_newline);
+  return masks;
+}
+
+json_force_inline block_masks classify(const char *block) {
+  const auto c0 = classify_chunk(block);
+  const auto c1 = classify_chunk(block + 16);
+  const auto c2 = classify_chunk(block + 32);
+  const auto c3 = classify_chunk(block + 48);
+
+  block_masks masks;
+  masks.quote = movemask(c0.quote, c1.quote, c2.quote, c3.quote);
+  masks.backslash = movemask(c0.backslash, c1.backslash, c2.backslash, c3.backslash);
+  masks.open = movemask(c0.open, c1.open, c2.open, c3.open);
+  masks.close = movemask(c0.close, c1.close, c2.close, c3.close);
+  masks.structural = movemask(c0.structural, c1.structural, c2.structural, c3.structural);
+  masks.whitespace = movemask(c0.whitespace, c1.whitespace, c2.whitespace, c3.whitespace);
+  return masks;
+}
+
+#else
+
+json_force_inline block_masks classify(const char *block) {
+  block_masks masks = { 0, 0, 0, 0, 0, 0 };
+  for (unsigned i = 0; i < 64; i++) {
+    const auto bit = uint64_t(1) << i;
+    switch (block[i]) {
+      case '"': masks.quote |= bit; break;
+      case '\\': masks.backslash |= bit; break;
+      case '{': case '[': masks.open |= bit; masks.structural |= bit; break;
+      case '}': case ']': masks.close |= bit; masks.structural |= bit; break;
+      case ':': case ',': masks.structural |= bit; break;
+      case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+      default: break;
+    }
+  }
+  return masks;
+}
+
+#endif  // defined(json_arch_x86_64)
+
+/**
+ * Find the characters that are escaped by a backslash. A backslash escapes the
+ * next character unless it is itself escaped, so what matters is whether each
+ * run of backslashes has an odd or even length. The runs are told apart by
+ * adding the odd-positioned run starts to the backslash mask, which carries
+ * through every run that starts on an odd bit. 'prev_escaped' carries the state
+ * over from the previous block.
+ */
+json_force_inline uint64_t find_escaped(uint64_t backslash, uint64_t &prev_escaped) {
+  const uint64_t even_bits = 0x5555555555555555ULL;
+  backslash &= ~prev_escaped;
+  const auto follows_escape = (backslash << 1) | prev_escaped;
+  const auto odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  const auto sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+  prev_escaped = (sequences_starting_on_even_bits < backslash ? 1 : 0);
+  const auto invert_mask = sequences_starting_on_even_bits << 1;
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+/**
+ * Compute the running XOR of all bits up to and including each bit. Given the
+ * unescaped quotes, this yields a mask of the bytes inside of strings, which
+ * includes the opening quotes but not the closing ones.
+ */
+json_force_inline uint64_t prefix_xor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
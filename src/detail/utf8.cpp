@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <spotify/json/detail/utf8.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const char *find_invalid_utf8(const char *begin, const char *end) {
+  auto pos = reinterpret_cast<const uint8_t *>(begin);
+  const auto last = reinterpret_cast<const uint8_t *>(end);
+
+  while (pos != last) {
+    // Most text is ASCII, so skip eight characters at a time while it is.
+    if (last - pos >= 8) {
+      uint64_t chunk;
+      std::memcpy(&chunk, pos, sizeof(chunk));
+      if (json_likely(!(chunk & 0x8080808080808080ULL))) {
+        pos += 8;
+        continue;
+      }
+    }
+
+    const auto c = *pos;
+    if (c < 0x80) {
+      pos++;
+      continue;
+    }
+
+    // The lead byte decides the number of continuation bytes and the range of
+    // the first one, which is narrower for the lead bytes that would otherwise
+    // allow overlong encodings, surrogates or too large code points.
+    auto num_continuation_bytes = 0;
+    auto first_min = uint8_t(0x80);
+    auto first_max = uint8_t(0xBF);
+    if (c >= 0xC2 && c <= 0xDF) {
+      num_continuation_bytes = 1;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      num_continuation_bytes = 2;
+      first_min = (c == 0xE0 ? 0xA0 : 0x80);
+      first_max = (c == 0xED ? 0x9F : 0xBF);
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      num_continuation_bytes = 3;
+      first_min = (c == 0xF0 ? 0x90 : 0x80);
+      first_max = (c == 0xF4 ? 0x8F : 0xBF);
+    } else {
+      return reinterpret_cast<const char *>(pos);
+    }
+
+    if (last - pos <= num_continuation_bytes ||
+        pos[1] < first_min ||
+        pos[1] > first_max) {
+      return reinterpret_cast<const char *>(pos);
+    }
+
+    for (auto i = 2; i <= num_continuation_bytes; i++) {
+      if ((pos[i] & 0xC0) != 0x80) {
+        return reinterpret_cast<const char *>(pos);
+      }
+    }
+
+    pos += num_continuation_bytes + 1;
+  }
+
+  return end;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
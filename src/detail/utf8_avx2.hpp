@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <immintrin.h>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Validates UTF-8 one 32 byte chunk at a time, with the lookup table algorithm
+ * by John Keiser and Daniel Lemire ("Validating UTF-8 In Less Than One
+ * Instruction Per Byte"). Each pair of adjacent bytes is classified with three
+ * nibble lookups, which leaves a bit set for every error that only depends on
+ * the pair. The remaining checks, for the third and fourth bytes of long
+ * sequences, compare the chunk with itself shifted by two and three bytes.
+ *
+ * Chunks must be passed in order, and the validator only knows about the last
+ * three bytes of the previous chunk. Since every sequence that is cut short is
+ * flagged by the byte after it, validating a chunk with zeros after the end of
+ * the input makes sure that the input does not end in the middle of a sequence.
+ */
+class utf8_validator_avx2 final {
+ public:
+  utf8_validator_avx2()
+      : _error(_mm256_setzero_si256()),
+        _prev_input(_mm256_setzero_si256()),
+        _prev_incomplete(_mm256_setzero_si256()) {}
+
+  json_force_inline void check(const __m256i input) {
+    if (json_likely(!_mm256_movemask_epi8(input))) {
+      // An ASCII chunk is valid, but the previous chunk may have ended in the
+      // middle of a sequence that this chunk should have continued.
+      _error = _mm256_or_si256(_error, _prev_incomplete);
+      _prev_incomplete = _mm256_setzero_si256();
+    } else {
+      const auto prev1 = prev<1>(input);
+      const auto special_cases = check_special_cases(input, prev1);
+      const auto lengths = check_multibyte_lengths(input, special_cases);
+      _error = _mm256_or_si256(_error, lengths);
+      _prev_incomplete = is_incomplete(input);
+    }
+    _prev_input = input;
+  }
+
+  json_force_inline bool has_error() const {
+    return !_mm256_testz_si256(_error, _error);
+  }
+
+ private:
+  // Bit flags for the errors that can be detected from a pair of bytes.
+  static const uint8_t too_short = 1 << 0;    // 11______ 0_______ or 11______ 11______
+  static const uint8_t too_long = 1 << 1;     // 0_______ 10______
+  static const uint8_t overlong_3 = 1 << 2;   // 11100000 100_____
+  static const uint8_t too_large = 1 << 3;    // 11110100 1001____ or 11110100 101_____
+  static const uint8_t surrogate = 1 << 4;    // 11101101 101_____
+  static const uint8_t overlong_2 = 1 << 5;   // 1100000_ 10______
+  static const uint8_t too_large_1000 = 1 << 6;  // 11110101 1000____ and above
+  static const uint8_t overlong_4 = 1 << 6;   // 11110000 1000____
+  static const uint8_t two_conts = 1 << 7;    // 10______ 10______
+  static const uint8_t carry = too_short | too_long | two_conts;
+
+  /**
+   * The input shifted right by N bytes, with the last N bytes of the previous
+   * chunk shifted in.
+   */
+  template <int N>
+  json_force_inline __m256i prev(const __m256i input) const {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(_prev_input, input, 0x21), 16 - N);
+  }
+
+  json_force_inline static __m256i lookup(
+      const __m256i nibbles,
+      const uint8_t t0, const uint8_t t1, const uint8_t t2, const uint8_t t3,
+      const uint8_t t4, const uint8_t t5, const uint8_t t6, const uint8_t t7,
+      const uint8_t t8, const uint8_t t9, const uint8_t ta, const uint8_t tb,
+      const uint8_t tc, const uint8_t td, const uint8_t te, const uint8_t tf) {
+    const auto table = _mm256_setr_epi8(
+        t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, ta, tb, tc, td, te, tf,
+        t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, ta, tb, tc, td, te, tf);
+    return _mm256_shuffle_epi8(table, nibbles);
+  }
+
+  json_force_inline static __m256i high_nibbles(const __m256i input) {
+    return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+  }
+
+  json_force_inline static __m256i check_special_cases(const __m256i input, const __m256i prev1) {
+    const auto byte_1_high = lookup(high_nibbles(prev1),
+        // 0_______ ________ <ASCII in byte 1>
+        too_long, too_long, too_long, too_long,
+        too_long, too_long, too_long, too_long,
+        // 10______ ________ <continuation in byte 1>
+        two_conts, two_conts, two_conts, two_conts,
+        // 1100____ ________ <two byte lead in byte 1>
+        too_short | overlong_2,
+        // 1101____ ________ <two byte lead in byte 1>
+        too_short,
+        // 1110____ ________ <three byte lead in byte 1>
+        too_short | overlong_3 | surrogate,
+        // 1111____ ________ <four+ byte lead in byte 1>
+        too_short | too_large | too_large_1000 | overlong_4);
+
+    const auto byte_1_low = lookup(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)),
+        // ____0000 ________
+        carry | overlong_3 | overlong_2 | overlong_4,
+        // ____0001 ________
+        carry | overlong_2,
+        // ____001_ ________
+        carry,
+        carry,
+        // ____0100 ________
+        carry | too_large,
+        // ____0101 ________
+        carry | too_large | too_large_1000,
+        // ____011_ ________
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        // ____1___ ________
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        // ____1101 ________
+        carry | too_large | too_large_1000 | surrogate,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000);
+
+    const auto byte_2_high = lookup(high_nibbles(input),
+        // ________ 0_______ <ASCII in byte 2>
+        too_short, too_short, too_short, too_short,
+        too_short, too_short, too_short, too_short,
+        // ________ 1000____
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        // ________ 1001____
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        // ________ 101_____
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        // ________ 11______
+        too_short, too_short, too_short, too_short);
+
+    return _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+  }
+
+  /**
+   * Two continuation bytes in a row are only valid when the byte two or three
+   * positions back is the lead byte of a three or four byte sequence. The
+   * two_conts bit is the high bit, so the error is whatever does not match.
+   */
+  json_force_inline __m256i check_multibyte_lengths(const __m256i input, const __m256i special_cases) const {
+    const auto prev2 = prev<2>(input);
+    const auto prev3 = prev<3>(input);
+    const auto is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80)));
+    const auto is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80)));
+    const auto must_be_continuation = _mm256_and_si256(
+        _mm256_or_si256(is_third_byte, is_fourth_byte),
+        _mm256_set1_epi8(char(0x80)));
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+  }
+
+  /**
+   * Non-zero where one of the last three bytes of the chunk starts a sequence
+   * that does not fit in the chunk.
+   */
+  json_force_inline static __m256i is_incomplete(const __m256i input) {
+    const char x = char(0xFF);
+    const auto max_value = _mm256_setr_epi8(
+        x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x,
+        x, x, x, x, x, x, x, x, x, x, x, x, x,
+        char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+    return _mm256_subs_epu8(input, max_value);
+  }
+
+  __m256i _error;
+  __m256i _prev_input;
+  __m256i _prev_incomplete;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <immintrin.h>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * See utf8_validator_avx2 in utf8_avx2.hpp, this is the same algorithm for 64
+ * byte chunks. The lookup tables are repeated in each 128 bit lane.
+ */
+class utf8_validator_avx512 final {
+ public:
+  utf8_validator_avx512()
+      : _error(_mm512_setzero_si512()),
+        _prev_input(_mm512_setzero_si512()),
+        _prev_incomplete(_mm512_setzero_si512()) {}
+
+  json_force_inline void check(const __m512i input) {
+    if (json_likely(!_mm512_movepi8_mask(input))) {
+      _error = _mm512_or_si512(_error, _prev_incomplete);
+      _prev_incomplete = _mm512_setzero_si512();
+    } else {
+      const auto prev1 = prev<1>(input);
+      const auto special_cases = check_special_cases(input, prev1);
+      const auto lengths = check_multibyte_lengths(input, special_cases);
+      _error = _mm512_or_si512(_error, lengths);
+      _prev_incomplete = is_incomplete(input);
+    }
+    _prev_input = input;
+  }
+
+  json_force_inline bool has_error() const {
+    return _mm512_test_epi8_mask(_error, _error) != 0;
+  }
+
+ private:
+  static const uint8_t too_short = 1 << 0;
+  static const uint8_t too_long = 1 << 1;
+  static const uint8_t overlong_3 = 1 << 2;
+  static const uint8_t too_large = 1 << 3;
+  static const uint8_t surrogate = 1 << 4;
+  static const uint8_t overlong_2 = 1 << 5;
+  static const uint8_t too_large_1000 = 1 << 6;
+  static const uint8_t overlong_4 = 1 << 6;
+  static const uint8_t two_conts = 1 << 7;
+  static const uint8_t carry = too_short | too_long | two_conts;
+
+  /**
+   * The input shifted right by N bytes, with the last N bytes of the previous
+   * chunk shifted in. The permute lines up each 128 bit lane of the input with
+   * the lane before it, since the byte alignment only works within lanes.
+   */
+  template <int N>
+  json_force_inline __m512i prev(const __m512i input) const {
+    const auto lanes_before = _mm512_permutex2var_epi64(
+        _prev_input, _mm512_setr_epi64(6, 7, 8, 9, 10, 11, 12, 13), input);
+    return _mm512_alignr_epi8(input, lanes_before, 16 - N);
+  }
+
+  json_force_inline static __m512i lookup(
+      const __m512i nibbles,
+      const uint8_t t0, const uint8_t t1, const uint8_t t2, const uint8_t t3,
+      const uint8_t t4, const uint8_t t5, const uint8_t t6, const uint8_t t7,
+      const uint8_t t8, const uint8_t t9, const uint8_t ta, const uint8_t tb,
+      const uint8_t tc, const uint8_t td, const uint8_t te, const uint8_t tf) {
+    const auto table = _mm512_broadcast_i32x4(_mm_setr_epi8(
+        t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, ta, tb, tc, td, te, tf));
+    return _mm512_shuffle_epi8(table, nibbles);
+  }
+
+  json_force_inline static __m512i high_nibbles(const __m512i input) {
+    return _mm512_and_si512(_mm512_srli_epi16(input, 4), _mm512_set1_epi8(0x0F));
+  }
+
+  json_force_inline static __m512i check_special_cases(const __m512i input, const __m512i prev1) {
+    const auto byte_1_high = lookup(high_nibbles(prev1),
+        too_long, too_long, too_long, too_long,
+        too_long, too_long, too_long, too_long,
+        two_conts, two_conts, two_conts, two_conts,
+        too_short | overlong_2,
+        too_short,
+        too_short | overlong_3 | surrogate,
+        too_short | too_large | too_large_1000 | overlong_4);
+
+    const auto byte_1_low = lookup(_mm512_and_si512(prev1, _mm512_set1_epi8(0x0F)),
+        carry | overlong_3 | overlong_2 | overlong_4,
+        carry | overlong_2,
+        carry,
+        carry,
+        carry | too_large,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000);
+
+    const auto byte_2_high = lookup(high_nibbles(input),
+        too_short, too_short, too_short, too_short,
+        too_short, too_short, too_short, too_short,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_short, too_short, too_short, too_short);
+
+    return _mm512_and_si512(_mm512_and_si512(byte_1_high, byte_1_low), byte_2_high);
+  }
+
+  json_force_inline __m512i check_multibyte_lengths(const __m512i input, const __m512i special_cases) const {
+    const auto prev2 = prev<2>(input);
+    const auto prev3 = prev<3>(input);
+    const auto is_third_byte = _mm512_subs_epu8(prev2, _mm512_set1_epi8(char(0xE0 - 0x80)));
+    const auto is_fourth_byte = _mm512_subs_epu8(prev3, _mm512_set1_epi8(char(0xF0 - 0x80)));
+    const auto must_be_continuation = _mm512_and_si512(
+        _mm512_or_si512(is_third_byte, is_fourth_byte),
+        _mm512_set1_epi8(char(0x80)));
+    return _mm512_xor_si512(must_be_continuation, special_cases);
+  }
+
+  json_force_inline static __m512i is_incomplete(const __m512i input) {
+    const char x = char(0xFF);
+    const auto max_value = _mm512_inserti32x4(_mm512_set1_epi8(x), _mm_setr_epi8(
+        x, x, x, x, x, x, x, x, x, x, x, x, x,
+        char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1)), 3);
+    return _mm512_subs_epu8(input, max_value);
+  }
+
+  __m512i _error;
+  __m512i _prev_input;
+  __m512i _prev_incomplete;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
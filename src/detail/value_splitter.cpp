@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/value_splitter.hpp>
+
+#include <string>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * The characters that end a number or literal (true, false, null) at the top
+ * level. Anything else is left for the codec to reject.
+ */
+json_force_inline bool is_scalar_delimiter(const char c) {
+  switch (c) {
+    case ' ': case '\t': case '\n': case '\r':
+    case ',': case ':': case '"':
+    case '[': case ']': case '{': case '}':
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+value_splitter::value_splitter(const bool array_elements)
+    : _state(array_elements ? state::before_array : state::before_value),
+      _array_elements(array_elements) {}
+
+void value_splitter::push(const char *data, const size_t size) {
+  _chunk_begin = data;
+  _chunk_end = data + size;
+  _position = data;
+  _value_begin = data;
+}
+
+bool value_splitter::next() {
+  while (true) {
+    switch (_state) {
+      case state::before_array:
+        if (!skip_whitespace()) { return end_of_chunk(); }
+        if (*_position != '[') { fail("Expected '['"); }
+        _position++;
+        _state = state::before_first_element;
+        break;
+      case state::before_first_element:
+        if (!skip_whitespace()) { return end_of_chunk(); }
+        if (*_position == ']') {
+          _position++;
+          _state = state::after_array;
+        } else {
+          start_value();
+        }
+        break;
+      case state::before_value:
+        if (!skip_whitespace()) { return end_of_chunk(); }
+        start_value();
+        break;
+      case state::in_value:
+        if (!scan_value()) { return end_of_chunk(); }
+        _state = (_array_elements ? state::after_element : state::before_value);
+        return true;
+      case state::after_element:
+        if (!skip_whitespace()) { return end_of_chunk(); }
+        switch (*(_position++)) {
+          case ',': _state = state::before_value; break;
+          case ']': _state = state::after_array; break;
+          default: fail("Expected ',' or ']'", -1);
+        }
+        break;
+      case state::after_array:
+        if (!skip_whitespace()) { return end_of_chunk(); }
+        fail("Unexpected trailing input");
+    }
+  }
+}
+
+bool value_splitter::finish() {
+  if (_state == state::in_value && _in_scalar && !_array_elements) {
+    // The scalar was copied to the buffer at the end of the last chunk.
+    _value_data = _buffer.data();
+    _value_size = _buffer.size();
+    _state = state::before_value;
+    return true;
+  }
+
+  const auto expected = (_array_elements ? state::after_array : state::before_value);
+  if (_state != expected) {
+    fail("Unexpected EOF");
+  }
+  return false;
+}
+
+bool value_splitter::skip_whitespace() {
+  decode_context context(_position, _chunk_end);
+  skip_any_whitespace(context);
+  _position = context.position;
+  return (_position != _chunk_end);
+}
+
+void value_splitter::start_value() {
+  const auto c = *_position;
+  switch (c) {
+    case ',': case ':': case ']': case '}':
+      fail((std::string("Encountered token '") + c + "'").c_str());
+    default:
+      break;
+  }
+
+  _value_begin = _position;
+  _value_offset = _chunk_offset + (_position - _chunk_begin);
+  _buffer.clear();
+  _depth = 0;
+  _in_string = false;
+  _in_escape = false;
+  _in_scalar = (c != '{' && c != '[' && c != '"');
+  _state = state::in_value;
+}
+
+bool value_splitter::scan_value() {
+  auto p = _position;
+  const auto end = _chunk_end;
+
+  if (_in_scalar) {
+    while (p != end && !is_scalar_delimiter(*p)) {
+      p++;
+    }
+    _position = p;
+    if (p == end) {
+      return false;
+    }
+    complete_value(p);
+    return true;
+  }
+
+  while (p != end) {
+    if (_in_string) {
+      if (_in_escape) {
+        // The character after a backslash can not end the string. The four
+        // hex digits of a \u escape can not either, so they need no state.
+        _in_escape = false;
+        p++;
+        continue;
+      }
+
+      decode_context context(p, end);
+      skip_any_simple_characters(context);
+      p = context.position;
+      if (p == end) {
+        break;
+      }
+
+      switch (*(p++)) {
+        case '"':
+          _in_string = false;
+          if (_depth == 0) {
+            complete_value(p);
+            return true;
+          }
+          break;
+        case '\\':
+          _in_escape = true;
+          break;
+        default:
+          // A control character, which the codec will reject.
+          break;
+      }
+      continue;
+    }
+
+    switch (*(p++)) {
+      case '"':
+        _in_string = true;
+        break;
+      case '{': case '[':
+        _depth++;
+        break;
+      case '}': case ']':
+        if (--_depth == 0) {
+          complete_value(p);
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  _position = p;
+  return false;
+}
+
+void value_splitter::complete_value(const char *value_end) {
+  _position = value_end;
+  if (_buffer.empty()) {
+    _value_data = _value_begin;
+    _value_size = (value_end - _value_begin);
+  } else {
+    _buffer.append(_value_begin, value_end);
+    _value_data = _buffer.data();
+    _value_size = _buffer.size();
+  }
+}
+
+bool value_splitter::end_of_chunk() {
+  if (_state == state::in_value) {
+    _buffer.append(_value_begin, _chunk_end);
+  }
+
+  // Leave an empty chunk behind, so that calling next() again is harmless.
+  _chunk_offset += (_chunk_end - _chunk_begin);
+  _chunk_begin = _chunk_end;
+  _value_begin = _chunk_end;
+  return false;
+}
+
+void value_splitter::fail(const char *error, const ptrdiff_t d) const {
+  throw decode_exception(error, _chunk_offset + (_position - _chunk_begin) + d);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
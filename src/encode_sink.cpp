@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/encode_sink.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif  // defined(_WIN32)
+
+#include <spotify/json/encode_exception.hpp>
+
+namespace spotify {
+namespace json {
+
+fd_sink::fd_sink(const int fd)
+    : _fd(fd) {}
+
+void fd_sink::write(const char *data, size_t size) {
+  while (size) {
+#if defined(_WIN32)
+    const auto chunk = static_cast<unsigned>(std::min<size_t>(size, 1 << 30));
+    const auto written = ::_write(_fd, data, chunk);
+#else
+    const auto written = ::write(_fd, data, size);
+#endif  // defined(_WIN32)
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "Could not write encoded JSON");
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+ostream_sink::ostream_sink(std::ostream &stream)
+    : _stream(stream) {}
+
+void ostream_sink::write(const char *data, const size_t size) {
+  if (!_stream.write(data, static_cast<std::streamsize>(size))) {
+    throw std::ios_base::failure("Could not write encoded JSON");
+  }
+}
+
+callback_sink::callback_sink(callback_type callback)
+    : _callback(std::move(callback)) {}
+
+void callback_sink::write(const char *data, const size_t size) {
+  _callback(data, size);
+}
+
+buffer_sink::buffer_sink(char *data, const size_t capacity)
+    : _data(data),
+      _capacity(capacity) {}
+
+void buffer_sink::write(const char *data, const size_t size) {
+  if (size > _capacity - _size) {
+    throw encode_exception("The encoded JSON does not fit in the buffer");
+  }
+  if (data != _data + _size) {
+    std::memcpy(_data + _size, data, size);
+  }
+  _size += size;
+}
+
+char *buffer_sink::direct_buffer(size_t &capacity) {
+  capacity = _capacity - _size;
+  return _data + _size;
+}
+
+void gather_sink::write(const char *data, const size_t size) {
+  _blocks.emplace_back(data, size);
+  _size += size;
+}
+
+std::vector<gather_sink::buffer> gather_sink::buffers() const {
+  std::vector<buffer> buffers;
+  buffers.reserve(_blocks.size());
+  for (const auto &block : _blocks) {
+    buffers.push_back(buffer{ block.data(), block.size() });
+  }
+  return buffers;
+}
+
+void gather_sink::clear() {
+  _blocks.clear();
+  _size = 0;
+}
+
+}  // namespace json
+}  // namespace spotify
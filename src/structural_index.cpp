@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/structural_index.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <spotify/json/detail/macros.hpp>
+
+#include "detail/bits_common.hpp"
+#include "detail/structural_common.hpp"
+
+namespace spotify {
+namespace json {
+structural_index::structural_index(const char *begin, const char *end)
+    : _begin(begin),
+      _end(end),
+      _valid(false),
+      _cursor(0) {
+  build();
+}
+
+structural_index::structural_index(const char *data, size_t size)
+    : structural_index(data, data + size) {}
+
+const char *structural_index::next_token(const char *position) {
+  const auto index = find_token(static_cast<uint32_t>(position - _begin));
+  return (index < _tokens.size() ? _begin + _tokens[index] : _end);
+}
+
+const char *structural_index::skip_container(const char *position) {
+  const auto offset = static_cast<uint32_t>(position - _begin);
+  const auto index = find_token(offset);
+  if (json_unlikely(index == _tokens.size() || _tokens[index] != offset)) {
+    return nullptr;
+  }
+
+  const auto closer = _matches[index];
+  _cursor = closer + 1;
+  return _begin + _tokens[closer] + 1;
+}
+
+void structural_index::build() {
+  const auto size = static_cast<size_t>(_end - _begin);
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    return;
+  }
+
+  // Minified JSON has a token every four to eight bytes, so this avoids most
+  // of the reallocations without overcommitting too much for string heavy
+  // documents.
+  _tokens.reserve(size / 4 + 1);
+
+  uint64_t prev_escaped = 0;
+  uint64_t prev_in_string = 0;
+  uint64_t prev_separator = 1;  // the start of the input acts like a separator
+
+  for (size_t offset = 0; offset < size; offset += 64) {
+    detail::block_masks masks;
+    if (json_likely(size - offset >= 64)) {
+      masks = detail::classify(_begin + offset);
+    } else {
+      char padded[64];
+      std::memset(padded, ' ', sizeof(padded));
+      std::memcpy(padded, _begin + offset, size - offset);
+      masks = detail::classify(padded);
+    }
+
+    const auto escaped = detail::find_escaped(masks.backslash, prev_escaped);
+    const auto quote = masks.quote & ~escaped;
+    const auto in_string = detail::prefix_xor(quote) ^ prev_in_string;
+    prev_in_string = uint64_t(0) - (in_string >> 63);
+
+    // A number or literal starts with any character that is not whitespace,
+    // structural or part of a string, and that follows a separator.
+    const auto separators = masks.structural | masks.whitespace;
+    const auto follows_separator = (separators << 1) | prev_separator;
+    prev_separator = (separators >> 63);
+    const auto scalar = ~(separators | quote | in_string);
+
+    auto tokens = (masks.structural & ~in_string) | (quote & in_string) | (scalar & follows_separator);
+    while (tokens) {
+      _tokens.push_back(static_cast<uint32_t>(offset + detail::count_trailing_zeros(tokens)));
+      tokens &= (tokens - 1);
+    }
+  }
+
+  if (!prev_in_string) {
+    match_containers();
+  }
+
+  if (!_valid) {
+    std::vector<uint32_t>().swap(_tokens);
+    std::vector<uint32_t>().swap(_matches);
+  }
+}
+
+void structural_index::match_containers() {
+  _matches.resize(_tokens.size());
+
+  std::vector<uint32_t> open;
+  for (size_t i = 0; i < _tokens.size(); i++) {
+    const auto c = _begin[_tokens[i]];
+    if (c == '{' || c == '[') {
+      open.push_back(static_cast<uint32_t>(i));
+    } else if (c == '}' || c == ']') {
+      if (open.empty() || _begin[_tokens[open.back()]] + 2 != c) {  // '{' + 2 == '}', '[' + 2 == ']'
+        return;
+      }
+      _matches[open.back()] = static_cast<uint32_t>(i);
+      open.pop_back();
+    }
+  }
+
+  _valid = open.empty();
+}
+
+size_t structural_index::find_token(const uint32_t offset) {
+  const auto tokens_begin = _tokens.begin();
+  const auto tokens_end = _tokens.end();
+  auto cursor = _cursor;
+
+  // Codecs such as one_of_t rewind the context when a codec fails, in which
+  // case the cursor is ahead of the position and needs to be searched for.
+  if (json_unlikely(cursor > 0 && _tokens[cursor - 1] >= offset)) {
+    cursor = std::lower_bound(tokens_begin, tokens_begin + cursor, offset) - tokens_begin;
+  }
+
+  // Usually the position has only moved a token or two since the last lookup,
+  // so try a few steps forward before falling back to a binary search.
+  for (auto steps = 0; cursor < _tokens.size() && _tokens[cursor] < offset; cursor++, steps++) {
+    if (steps == 8) {
+      cursor = std::lower_bound(tokens_begin + cursor, tokens_end, offset) - tokens_begin;
+      break;
+    }
+  }
+
+  _cursor = cursor;
+  return cursor;
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track {
+  arena_string uri;
+  arena_vector<arena_string> artists;
+};
+
+codec::object_t<track> track_codec() {
+  auto codec = codec::object<track>();
+  codec.required("uri", &track::uri);
+  codec.optional("artists", &track::artists);
+  return codec;
+}
+
+template <typename container_type>
+bool uses_arena(const container_type &container, const arena &arena) {
+  return (container.get_allocator().arena() == &arena);
+}
+
+}  // namespace
+
+/*
+ * arena
+ */
+
+BOOST_AUTO_TEST_CASE(json_arena_should_allocate_aligned_memory) {
+  arena arena(64);
+  const auto a = static_cast<char *>(arena.allocate(1, 1));
+  const auto b = arena.allocate(8, 8);
+  const auto c = arena.allocate(32, 32);
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(b) % 8, 0);
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(c) % 32, 0);
+  BOOST_CHECK(static_cast<char *>(b) > a);
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_allocate_more_than_one_block) {
+  arena arena(64);
+  for (int i = 0; i < 100; i++) {
+    std::memset(arena.allocate(48, 8), i, 48);
+  }
+  BOOST_CHECK_GE(arena.capacity(), 4800);
+  std::memset(arena.allocate(100000, 16), 0, 100000);
+  BOOST_CHECK_GE(arena.capacity(), 104800);
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_keep_the_largest_block_when_reset) {
+  arena arena(64);
+  for (int i = 0; i < 100; i++) {
+    arena.allocate(48, 8);
+  }
+  arena.reset();
+  const auto capacity = arena.capacity();
+  BOOST_CHECK_GE(capacity, 2400);
+
+  for (int i = 0; i < 40; i++) {
+    arena.allocate(48, 8);
+  }
+  BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_allocator_should_fall_back_to_the_heap) {
+  arena_vector<int> vector;
+  vector.assign(1000, 7);
+  BOOST_CHECK_EQUAL(vector[999], 7);
+  BOOST_CHECK(vector.get_allocator().arena() == nullptr);
+}
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_arena_should_be_used_for_strings) {
+  arena arena;
+  const auto short_string = decode(default_codec<arena_string>(), R"("a")", arena);
+  const auto long_string = decode(default_codec<arena_string>(), R"("a string that is too long for SSO\n")", arena);
+  BOOST_CHECK(short_string == "a");
+  BOOST_CHECK(long_string == "a string that is too long for SSO\n");
+  BOOST_CHECK(uses_arena(long_string, arena));
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_be_used_for_arrays) {
+  arena arena;
+  const std::string json = R"(["a string that is too long for SSO", "b"])";
+  const auto decoded = decode(default_codec<arena_vector<arena_string>>(), json, arena);
+  BOOST_REQUIRE_EQUAL(decoded.size(), 2);
+  BOOST_CHECK(decoded[0] == "a string that is too long for SSO");
+  BOOST_CHECK(decoded[1] == "b");
+  BOOST_CHECK(uses_arena(decoded, arena));
+  BOOST_CHECK(uses_arena(decoded[0], arena));
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_be_used_for_maps) {
+  arena arena;
+  const std::string json = R"({"a":1,"b":2})";
+  const auto decoded = decode(default_codec<arena_map<arena_string, int>>(), json, arena);
+  BOOST_REQUIRE_EQUAL(decoded.size(), 2);
+  BOOST_CHECK_EQUAL(decoded.begin()->second, 1);
+  BOOST_CHECK(decoded.begin()->first == "a");
+  BOOST_CHECK(uses_arena(decoded, arena));
+
+  const auto unordered = decode(default_codec<arena_unordered_map<std::string, int>>(), json, arena);
+  BOOST_CHECK_EQUAL(unordered.at("b"), 2);
+  BOOST_CHECK(uses_arena(unordered, arena));
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_be_used_for_shared_ptrs) {
+  arena arena(64);
+  const auto capacity = arena.capacity();
+  const auto decoded = decode(default_codec<std::shared_ptr<int>>(), "17", arena);
+  BOOST_CHECK_EQUAL(*decoded, 17);
+  BOOST_CHECK_GT(arena.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_be_used_for_object_fields) {
+  arena arena;
+  const std::string json = R"({"uri":"spotify:track:05341EWu6uHUg2BojF3Cyw","artists":["a", "b"]})";
+  const auto decoded = decode(track_codec(), json, arena);
+  BOOST_CHECK(decoded.uri == "spotify:track:05341EWu6uHUg2BojF3Cyw");
+  BOOST_CHECK(uses_arena(decoded.uri, arena));
+  BOOST_CHECK(uses_arena(decoded.artists, arena));
+  BOOST_REQUIRE_EQUAL(decoded.artists.size(), 2);
+  BOOST_CHECK(decoded.artists[1] == "b");
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_should_not_be_required_for_arena_containers) {
+  const std::string json = R"({"uri":"spotify:track:05341EWu6uHUg2BojF3Cyw","artists":["a"]})";
+  const auto decoded = decode(track_codec(), json);
+  BOOST_CHECK(decoded.uri == "spotify:track:05341EWu6uHUg2BojF3Cyw");
+  BOOST_CHECK(decoded.uri.get_allocator().arena() == nullptr);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_arena_containers_should_be_encoded) {
+  arena arena;
+  const std::string json = R"({"uri":"x","artists":["a","b"]})";
+  BOOST_CHECK_EQUAL(encode(track_codec(), decode(track_codec(), json, arena)), json);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
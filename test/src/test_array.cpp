@@ -14,6 +14,9 @@
  * the License.
  */
 
+#include <array>
+#include <list>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -24,6 +27,7 @@
 #include <spotify/json/codec/boolean.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/omit.hpp>
+#include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
@@ -194,6 +198,18 @@ BOOST_AUTO_TEST_CASE(json_codec_array_should_not_encode_omitted_elements_vector)
   BOOST_CHECK_EQUAL(encode(codec, vec), "[]");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_array_should_have_encoded_size_of_vector) {
+  const auto codec = default_codec<std::vector<int>>();
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::vector<int>()), 2);
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::vector<int>{ 7 }), 3);
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::vector<int>{ -4, 90 }), 7);
+  BOOST_CHECK_EQUAL(array<std::vector<bool>>(omit<bool>()).encoded_size({ false, true }), 2);
+
+  const std::vector<encoded_value> vec = {
+      encoded_value("false"), encoded_value("true") };
+  BOOST_CHECK_EQUAL(default_codec<std::vector<encoded_value>>().encoded_size(vec), 12);
+}
+
 /*
  * Array Encoding
  */
@@ -231,6 +247,112 @@ BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_empty_unordered_set) {
   BOOST_CHECK(array_parse<std::unordered_set<bool>>("[]").empty());
 }
 
+/*
+ * Decoding in place
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_vector) {
+  std::vector<int> value(16, 7);
+  const auto data = value.data();
+  decode_into(default_codec<std::vector<int>>(), "[1,2,3]", value);
+  BOOST_CHECK(value == std::vector<int>({ 1, 2, 3 }));
+  BOOST_CHECK_EQUAL(value.data(), data);
+
+  decode_into(default_codec<std::vector<int>>(), "[1,2,3,4,5]", value);
+  BOOST_CHECK(value == std::vector<int>({ 1, 2, 3, 4, 5 }));
+  BOOST_CHECK_EQUAL(value.data(), data);
+
+  decode_into(default_codec<std::vector<int>>(), "[]", value);
+  BOOST_CHECK(value.empty());
+  BOOST_CHECK_EQUAL(value.capacity(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_elements) {
+  std::vector<std::string> value{ std::string(64, 'x'), std::string(64, 'y') };
+  const auto data = value[1].data();
+  decode_into(default_codec<std::vector<std::string>>(), R"(["a","b","c"])", value);
+  BOOST_CHECK(value == std::vector<std::string>({ "a", "b", "c" }));
+  BOOST_CHECK_EQUAL(static_cast<const void *>(value[1].data()), static_cast<const void *>(data));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_vector_of_bool) {
+  std::vector<bool> value{ false, false, false };
+  decode_into(default_codec<std::vector<bool>>(), "[true,false,true,true]", value);
+  BOOST_CHECK(value == std::vector<bool>({ true, false, true, true }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_list) {
+  std::list<int> value{ 9, 9, 9 };
+  decode_into(default_codec<std::list<int>>(), "[1,2]", value);
+  BOOST_CHECK(value == std::list<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_set) {
+  std::set<int> value{ 9 };
+  decode_into(default_codec<std::set<int>>(), "[1,2,1]", value);
+  BOOST_CHECK(value == std::set<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_existing_std_array) {
+  std::array<int, 2> value{{ 9, 9 }};
+  decode_into(default_codec<std::array<int, 2>>(), "[1,2]", value);
+  BOOST_CHECK_EQUAL(value[0], 1);
+  BOOST_CHECK_EQUAL(value[1], 2);
+  BOOST_CHECK_THROW(
+      decode_into(default_codec<std::array<int, 2>>(), "[1]", value), decode_exception);
+  BOOST_CHECK_THROW(
+      decode_into(default_codec<std::array<int, 2>>(), "[1,2,3]", value), decode_exception);
+}
+
+/*
+ * Reserving
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_reserve_the_previously_decoded_size) {
+  std::string json = "[0";
+  for (int i = 1; i < 1000; i++) {
+    json += "," + std::to_string(i);
+  }
+  json += "]";
+
+  const auto codec = default_codec<std::vector<int>>();
+  BOOST_CHECK_EQUAL(decode(codec, json).size(), 1000);
+  const auto value = decode(codec, json);
+  BOOST_CHECK_EQUAL(value.size(), 1000);
+  BOOST_CHECK_EQUAL(value.capacity(), 1000);
+
+  const auto copy = codec;
+  BOOST_CHECK_EQUAL(decode(copy, json).capacity(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_not_reserve_more_than_the_input_can_hold) {
+  const auto codec = default_codec<std::vector<int>>();
+  std::string large = "[1";
+  for (int i = 0; i < 999; i++) {
+    large += ",1";
+  }
+  large += "]";
+  decode(codec, large);
+  BOOST_CHECK_LE(decode(codec, "[1,2]").capacity(), 2);
+  BOOST_CHECK(decode(codec, "[]").empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_cap_the_reserved_size) {
+  const auto codec = default_codec<std::vector<int>>();
+  std::string large = "[1";
+  for (int i = 0; i < 299999; i++) {
+    large += ",1";
+  }
+  large += "]";
+  BOOST_CHECK_EQUAL(decode(codec, large).size(), 300000);
+
+  const auto small = "[1,2]" + std::string(large.size(), ' ');
+  auto context = decode_context(small.data(), small.data() + small.size());
+  const auto value = codec.decode(context);
+  BOOST_CHECK_EQUAL(value.size(), 2);
+  BOOST_CHECK_LE(value.capacity() * sizeof(int), detail::max_size_hint_bytes);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
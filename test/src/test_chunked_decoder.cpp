@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/chunked_decoder.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_exception.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track {
+  std::string uri;
+  std::vector<int> plays;
+};
+
+codec::object_t<track> track_codec() {
+  auto codec = codec::object<track>();
+  codec.required("uri", &track::uri);
+  codec.optional("plays", &track::plays);
+  return codec;
+}
+
+/**
+ * Decode the input, fed in chunks of the given size.
+ */
+template <typename value_type>
+std::vector<value_type> decode_chunked(
+    const std::string &json,
+    const size_t chunk_size,
+    const chunked_input input = chunked_input::array_elements) {
+  std::vector<value_type> values;
+  const auto push = [&](value_type &&value) { values.push_back(std::move(value)); };
+  auto decoder = make_chunked_decoder<value_type>(input);
+  for (size_t i = 0; i < json.size(); i += chunk_size) {
+    // Copy each chunk, so that the decoder can not peek at the next one.
+    const auto chunk = json.substr(i, chunk_size);
+    decoder.feed(chunk, push);
+  }
+  decoder.finish(push);
+  return values;
+}
+
+/**
+ * Decode the input, fed in two chunks that are split at the given position.
+ */
+template <typename value_type>
+std::vector<value_type> decode_split(
+    const std::string &json,
+    const size_t split,
+    const chunked_input input = chunked_input::array_elements) {
+  std::vector<value_type> values;
+  const auto push = [&](value_type &&value) { values.push_back(std::move(value)); };
+  auto decoder = make_chunked_decoder<value_type>(input);
+  const auto head = json.substr(0, split);
+  const auto tail = json.substr(split);
+  decoder.feed(head, push);
+  decoder.feed(tail, push);
+  decoder.finish(push);
+  return values;
+}
+
+size_t decode_chunked_failure_offset(
+    const std::string &json,
+    const chunked_input input = chunked_input::array_elements) {
+  try {
+    decode_chunked<int>(json, 1, input);
+  } catch (const decode_exception &exception) {
+    return exception.offset();
+  }
+  BOOST_FAIL("Expected decode_exception");
+  return 0;
+}
+
+}  // namespace
+
+template <>
+struct default_codec_t<track> {
+  static codec::object_t<track> codec() {
+    return track_codec();
+  }
+};
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_array_elements) {
+  const auto values = decode_chunked<int>("[1, 2 ,3]", 1024);
+  BOOST_CHECK(values == std::vector<int>({ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_empty_array) {
+  BOOST_CHECK(decode_chunked<int>(" [ ] ", 1).empty());
+  BOOST_CHECK(decode_chunked<int>("[]", 1024).empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_array_split_anywhere) {
+  const std::string json =
+      R"( [{"uri":"spotify:track:1","plays":[1,2]},)"
+      R"({"plays":[],"uri":"a\"b\\cå]}[{"},)"
+      "\n" R"({"uri":"x"} ] )";
+
+  const auto expected = decode_chunked<track>(json, json.size());
+  BOOST_REQUIRE_EQUAL(expected.size(), 3);
+  BOOST_CHECK_EQUAL(expected[0].uri, "spotify:track:1");
+  BOOST_CHECK(expected[0].plays == std::vector<int>({ 1, 2 }));
+  BOOST_CHECK_EQUAL(expected[1].uri, "a\"b\\c\xC3\xA5]}[{");
+  BOOST_CHECK_EQUAL(expected[2].uri, "x");
+
+  for (size_t split = 0; split <= json.size(); split++) {
+    const auto values = decode_split<track>(json, split);
+    BOOST_REQUIRE_EQUAL(values.size(), expected.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      BOOST_CHECK_EQUAL(values[i].uri, expected[i].uri);
+      BOOST_CHECK(values[i].plays == expected[i].plays);
+    }
+  }
+
+  for (size_t chunk_size = 1; chunk_size < 8; chunk_size++) {
+    BOOST_CHECK_EQUAL(decode_chunked<track>(json, chunk_size).size(), expected.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_value_sequence) {
+  for (size_t split = 0; split <= 13; split++) {
+    const auto values = decode_split<std::string>(
+        "\"a\" \"bc\"\n\"\\\"\"", split, chunked_input::value_sequence);
+    BOOST_CHECK(values == std::vector<std::string>({ "a", "bc", "\"" }));
+  }
+
+  for (size_t split = 0; split <= 9; split++) {
+    const auto values = decode_split<int>("1\n22 -333", split, chunked_input::value_sequence);
+    BOOST_CHECK(values == std::vector<int>({ 1, 22, -333 }));
+  }
+
+  const auto tracks = decode_chunked<track>(
+      "{\"uri\":\"a\"}{\"uri\":\"b\"}\n", 3, chunked_input::value_sequence);
+  BOOST_REQUIRE_EQUAL(tracks.size(), 2);
+  BOOST_CHECK_EQUAL(tracks[1].uri, "b");
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_decode_single_document) {
+  const auto tracks = decode_chunked<track>(
+      R"({"uri":"a","plays":[1,2,3]})", 4, chunked_input::value_sequence);
+  BOOST_REQUIRE_EQUAL(tracks.size(), 1);
+  BOOST_CHECK(tracks[0].plays == std::vector<int>({ 1, 2, 3 }));
+  BOOST_CHECK(decode_chunked<int>(" \n", 1, chunked_input::value_sequence).empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_fail_on_invalid_structure) {
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset(" {}"), 1);
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("[1,,2]"), 3);
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("[1 2]"), 3);
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("[1,]"), 3);
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("[1] 2"), 4);
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("1 ]", chunked_input::value_sequence), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_fail_on_incomplete_input) {
+  BOOST_CHECK_THROW(decode_chunked<int>("", 1), decode_exception);
+  BOOST_CHECK_THROW(decode_chunked<int>("[1,2", 1), decode_exception);
+  BOOST_CHECK_THROW(decode_chunked<int>("[1", 1), decode_exception);
+  BOOST_CHECK_THROW(decode_chunked<std::string>("[\"a", 1), decode_exception);
+  BOOST_CHECK_THROW(decode_chunked<track>("{\"uri\":", 1, chunked_input::value_sequence), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_chunked_decoder_should_report_offsets_in_whole_input) {
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("[1, 2, 3x]"), 8);
+  BOOST_CHECK_EQUAL(decode_chunked_failure_offset("1 2 3x", chunked_input::value_sequence), 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -123,6 +123,38 @@ BOOST_AUTO_TEST_CASE(json_decode_should_throw_on_unexpected_trailing_input) {
   BOOST_CHECK_THROW(decode<custom_obj>(R"({"x":"h"} invalid)"), decode_exception);
 }
 
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_bytes_with_custom_codec) {
+  static const char * const kData = R"({"a":"e"})";
+  custom_obj obj;
+  decode_into(custom_codec(), kData, strlen(kData), obj);
+  BOOST_CHECK_EQUAL(obj.val, "e");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_cstring) {
+  custom_obj obj;
+  decode_into(R"({"x":"h"})", obj);
+  BOOST_CHECK_EQUAL(obj.val, "h");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_std_string) {
+  custom_obj obj;
+  decode_into(custom_codec(), std::string(R"({"a":"g"})"), obj);
+  BOOST_CHECK_EQUAL(obj.val, "g");
+  decode_into(std::string(R"({"x":"h"})"), obj);
+  BOOST_CHECK_EQUAL(obj.val, "h");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_accept_surrounding_space) {
+  int val = 0;
+  decode_into(" 53 ", val);
+  BOOST_CHECK_EQUAL(val, 53);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_throw_on_unexpected_trailing_input) {
+  custom_obj obj;
+  BOOST_CHECK_THROW(decode_into(R"({"x":"h"} invalid)", obj), decode_exception);
+}
+
 BOOST_AUTO_TEST_CASE(json_try_decode_should_decode_from_bytes_with_custom_codec) {
   static const char * const kData = R"({"a":"e"})";
   custom_obj obj;
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_batch.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct event {
+  std::string uri;
+  int ms_played = 0;
+};
+
+codec::object_t<event> event_codec() {
+  auto codec = codec::object<event>();
+  codec.required("uri", &event::uri);
+  codec.optional("ms_played", &event::ms_played);
+  return codec;
+}
+
+std::string generate_lines(const size_t count) {
+  std::string lines;
+  for (size_t i = 0; i < count; i++) {
+    lines += R"({"uri":"spotify:track:)" + std::to_string(i) + R"(","ms_played":)" + std::to_string(i) + "}\n";
+  }
+  return lines;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_decode_lines_in_order) {
+  const auto lines = generate_lines(10000);
+  for (const unsigned threads : { 1u, 2u, 7u }) {
+    const auto result = decode_batch(event_codec(), lines, batch_format::lines, threads);
+    BOOST_CHECK(result.ok());
+    BOOST_REQUIRE_EQUAL(result.values.size(), 10000);
+    for (size_t i = 0; i < result.values.size(); i++) {
+      BOOST_REQUIRE_EQUAL(result.values[i].ms_played, int(i));
+      BOOST_REQUIRE_EQUAL(result.values[i].uri, "spotify:track:" + std::to_string(i));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_skip_blank_lines) {
+  const auto result = decode_batch<int>(std::string("1\n\n  \r\n2\r\n3"));
+  BOOST_CHECK(result.ok());
+  BOOST_CHECK(result.values == std::vector<int>({ 1, 2, 3 }));
+  BOOST_CHECK(decode_batch<int>(std::string()).values.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_report_errors_per_line) {
+  const auto lines = std::string("{\"uri\":\"a\"}\n{\"uri\":\"b\n{}\n{\"uri\":\"c\"}\n");
+  const auto result = decode_batch(event_codec(), lines, batch_format::lines, 2);
+  BOOST_REQUIRE_EQUAL(result.values.size(), 4);
+  BOOST_CHECK_EQUAL(result.values[0].uri, "a");
+  BOOST_CHECK_EQUAL(result.values[3].uri, "c");
+  BOOST_REQUIRE_EQUAL(result.errors.size(), 2);
+  BOOST_CHECK_EQUAL(result.errors[0].index, 1);
+  BOOST_CHECK_EQUAL(result.errors[0].offset, 21);
+  BOOST_CHECK_EQUAL(result.errors[0].message, "Unterminated string");
+  BOOST_CHECK_EQUAL(result.errors[1].index, 2);
+  BOOST_CHECK_EQUAL(result.errors[1].offset, 24);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_default_construct_values_of_failed_records) {
+  const auto lines = std::string("{\"uri\":\"a\",\"ms_played\":1}\n{\"ms_played\":42,\"uri\":x}\n");
+  for (const unsigned threads : { 1u, 2u }) {
+    const auto result = decode_batch(event_codec(), lines, batch_format::lines, threads);
+    BOOST_REQUIRE_EQUAL(result.values.size(), 2);
+    BOOST_REQUIRE_EQUAL(result.errors.size(), 1);
+    BOOST_CHECK_EQUAL(result.errors[0].index, 1);
+    BOOST_CHECK_EQUAL(result.values[1].ms_played, 0);
+    BOOST_CHECK_EQUAL(result.values[1].uri, "");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_decode_many_batches_at_once) {
+  const auto lines = generate_lines(1000);
+  const auto decode_batches = [&](bool &ok) {
+    ok = true;
+    for (size_t i = 0; i < 50; i++) {
+      const auto result = decode_batch(event_codec(), lines, batch_format::lines, 4);
+      ok = ok && result.ok() && result.values[999].ms_played == 999;
+    }
+  };
+
+  // Boost.Test assertions are not thread safe, so the results are checked on
+  // the main thread.
+  bool ok_here = false;
+  bool ok_there = false;
+  std::thread other(decode_batches, std::ref(ok_there));
+  decode_batches(ok_here);
+  other.join();
+  BOOST_CHECK(ok_here);
+  BOOST_CHECK(ok_there);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_decode_concatenated_values) {
+  const auto json = std::string("{\"uri\":\"a\"}{\"uri\":\"b\"} {\"uri\":\"c\",\"ms_played\":3}\n");
+  const auto result = decode_batch(event_codec(), json, batch_format::concatenated);
+  BOOST_CHECK(result.ok());
+  BOOST_REQUIRE_EQUAL(result.values.size(), 3);
+  BOOST_CHECK_EQUAL(result.values[1].uri, "b");
+  BOOST_CHECK_EQUAL(result.values[2].ms_played, 3);
+
+  const auto numbers = decode_batch<int>(std::string("1 2\n3"), batch_format::concatenated);
+  BOOST_CHECK(numbers.values == std::vector<int>({ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_report_errors_in_concatenated_values) {
+  const auto json = std::string("{\"uri\":\"a\"}{}{\"uri\":\"b\"}]{\"uri\":\"c\"}");
+  const auto result = decode_batch(event_codec(), json, batch_format::concatenated);
+  BOOST_REQUIRE_EQUAL(result.values.size(), 3);
+  BOOST_CHECK_EQUAL(result.values[2].uri, "b");
+  BOOST_REQUIRE_EQUAL(result.errors.size(), 2);
+  BOOST_CHECK_EQUAL(result.errors[0].index, 1);
+  BOOST_CHECK_EQUAL(result.errors[1].index, 3);
+  BOOST_CHECK_EQUAL(result.errors[1].offset, 24);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_batch_should_only_accept_separately_writable_values) {
+  BOOST_CHECK(detail::is_batch_value<int>::value);
+  BOOST_CHECK(detail::is_batch_value<event>::value);
+  BOOST_CHECK(!detail::is_batch_value<bool>::value);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/decode_float.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+template <typename T>
+bool decode(const std::string &json, T &value, size_t &length) {
+  const char *number_end = nullptr;
+  const auto ok = decode_float_fast(json.data(), json.data() + json.size(), value, number_end);
+  length = (ok ? static_cast<size_t>(number_end - json.data()) : 0);
+  return ok;
+}
+
+uint64_t bits_of(const double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+uint32_t bits_of(const float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * Check that the number is either decoded to exactly the same value as the C
+ * library produces, or that it is left for the slow path.
+ */
+void verify_same_as_strtod(const std::string &json) {
+  double d = 0.0;
+  float f = 0.0f;
+  size_t length = 0;
+  if (decode(json, d, length)) {
+    BOOST_REQUIRE_MESSAGE(bits_of(d) == bits_of(std::strtod(json.c_str(), nullptr)), json);
+    BOOST_REQUIRE_EQUAL(length, json.size());
+  }
+  if (decode(json, f, length)) {
+    BOOST_REQUIRE_MESSAGE(bits_of(f) == bits_of(std::strtof(json.c_str(), nullptr)), json);
+    BOOST_REQUIRE_EQUAL(length, json.size());
+  }
+}
+
+template <typename T = double>
+void verify_decoded(const std::string &json) {
+  T value = 0;
+  size_t length = 0;
+  BOOST_CHECK_MESSAGE(decode(json, value, length), json);
+  verify_same_as_strtod(json);
+}
+
+void verify_not_decoded(const std::string &json) {
+  double d = 0.0;
+  size_t length = 0;
+  BOOST_CHECK_MESSAGE(!decode(json, d, length), json);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_decode_simple_numbers) {
+  verify_decoded("0");
+  verify_decoded("-0");
+  verify_decoded("0.25");
+  verify_decoded("-0.25");
+  verify_decoded("1.1");
+  verify_decoded("123.456");
+  verify_decoded("0.000123");
+  verify_decoded("1e10");
+  verify_decoded("1E-10");
+  verify_decoded("1e+5");
+  verify_decoded("-12.5e-3");
+  verify_decoded<float>("0.25");
+  verify_decoded<float>("-123.456");
+  verify_decoded<float>("1e-10");
+  verify_decoded<float>("3.4028234663852886e38");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_keep_the_sign_of_zero) {
+  double d = 1.0;
+  size_t length = 0;
+  BOOST_REQUIRE(decode("-0.0", d, length));
+  BOOST_CHECK(std::signbit(d));
+  BOOST_REQUIRE(decode("0e-5", d, length));
+  BOOST_CHECK(!std::signbit(d));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_round_correctly) {
+  verify_decoded("9007199254740993");  // 2^53 + 1, halfway, rounds to even
+  verify_decoded("9007199254740995");
+  verify_decoded("2.2250738585072011e-308");
+  verify_decoded("2.2250738585072014e-308");
+  verify_decoded("4.9e-324");
+  verify_decoded("2.4703282292062328e-324");
+  verify_decoded("2.4703282292062327e-324");
+  verify_decoded("1.7976931348623157e308");
+  verify_decoded("1.7976931348623159e308");
+  verify_decoded<float>("7.038531e-26");
+  verify_same_as_strtod("1.00000005960464477539062499");
+  verify_same_as_strtod("1.00000005960464477539062500");
+  verify_same_as_strtod("1.00000005960464477539062501");
+  verify_decoded<float>("16777217");  // 2^24 + 1, halfway, rounds to even
+  verify_decoded<float>("1.4e-45");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_decode_long_numbers) {
+  verify_same_as_strtod("3.14159265358979323846264338327950288");
+  verify_same_as_strtod("0.1000000000000000055511151231257827021181583404541015625");
+  verify_same_as_strtod("123456789012345678901234567890");
+  verify_same_as_strtod("1.0000000000000000000000000000");
+  verify_decoded("10000000000000000000000000000000");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_match_strtod_for_random_numbers) {
+  std::mt19937_64 rng(0x5eed);
+  char buffer[64];
+  for (int i = 0; i < 100000; i++) {
+    const auto bits = rng();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (value != value || value - value != 0.0) {
+      continue;  // NaN or infinity
+    }
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    verify_same_as_strtod(buffer);
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    verify_same_as_strtod(buffer);
+  }
+
+  std::uniform_int_distribution<int> num_digits(1, 25);
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::uniform_int_distribution<int> exponent(-350, 320);
+  for (int i = 0; i < 100000; i++) {
+    std::string json = std::to_string(1 + digit(rng) % 9);
+    const auto n = num_digits(rng);
+    for (int j = 0; j < n; j++) {
+      json += static_cast<char>('0' + digit(rng));
+      if (j == 0) {
+        json += '.';
+      }
+    }
+    json += "e" + std::to_string(exponent(rng));
+    verify_same_as_strtod(json);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_stop_at_the_end_of_the_number) {
+  double d = 0.0;
+  size_t length = 0;
+  BOOST_REQUIRE(decode("1.5]", d, length));
+  BOOST_CHECK_EQUAL(d, 1.5);
+  BOOST_CHECK_EQUAL(length, 3);
+  BOOST_REQUIRE(decode("-2e3,", d, length));
+  BOOST_CHECK_EQUAL(d, -2000.0);
+  BOOST_CHECK_EQUAL(length, 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_leave_non_json_numbers_to_the_slow_path) {
+  verify_not_decoded("");
+  verify_not_decoded("-");
+  verify_not_decoded("+1");
+  verify_not_decoded("01");
+  verify_not_decoded(".5");
+  verify_not_decoded("1.");
+  verify_not_decoded("1.e5");
+  verify_not_decoded("1e");
+  verify_not_decoded("1e+");
+  verify_not_decoded("NaN");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_float_fast_should_leave_huge_exponents_to_the_slow_path) {
+  verify_not_decoded("1e400");
+  verify_not_decoded("1e-400");
+  verify_not_decoded("1e99999999999999999999");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,13 +14,21 @@
  * the License.
  */
 
+#include <limits>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/any_value.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/lazy.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
+#include <spotify/json/encode_exception.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
@@ -37,6 +45,22 @@ codec::object_t<custom_obj> custom_codec() {
   return codec;
 }
 
+/**
+ * A codec that encodes a nested JSON document as a string, by calling encode
+ * while it is being used by encode.
+ */
+struct nested_codec {
+  using object_type = custom_obj;
+
+  object_type decode(decode_context &context) const {
+    return custom_codec().decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    codec::string().encode(context, json::encode(custom_codec(), value));
+  }
+};
+
 std::string value_to_string(const encoded_value_ref &value_ref) {
   return std::string(value_ref.data(), value_ref.size());
 }
@@ -68,6 +92,132 @@ BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_string) {
   BOOST_CHECK_EQUAL(encode(obj), R"({"x":"d"})");
 }
 
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_when_called_while_encoding) {
+  custom_obj obj;
+  obj.val = "e";
+  BOOST_CHECK_EQUAL(encode(nested_codec(), obj), R"("{\"a\":\"e\"}")");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_after_failing) {
+  BOOST_CHECK_THROW(encode(std::numeric_limits<double>::quiet_NaN()), encode_exception);
+  BOOST_CHECK_EQUAL(encode(1), "1");
+}
+
+/*
+ * json::encode_into
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_into_should_encode_into_string_with_custom_codec) {
+  custom_obj obj;
+  obj.val = "c";
+  std::string json(64, 'x');
+  const auto data = json.data();
+  encode_into(custom_codec(), obj, json);
+  BOOST_CHECK_EQUAL(json, R"({"a":"c"})");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(json.data()), static_cast<const void *>(data));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_into_should_encode_into_string) {
+  custom_obj obj;
+  obj.val = "d";
+  std::string json;
+  encode_into(obj, json);
+  BOOST_CHECK_EQUAL(json, R"({"x":"d"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_into_should_encode_into_context) {
+  custom_obj obj;
+  obj.val = "d";
+  encode_context context(16);
+  context.append("garbage", 7);
+  encode_into(custom_codec(), obj, context);
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), R"({"a":"d"})");
+  encode_into(obj, context);
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), R"({"x":"d"})");
+}
+
+/*
+ * json::encoded_size
+ */
+
+BOOST_AUTO_TEST_CASE(json_encoded_size_should_get_size_with_custom_codec) {
+  custom_obj obj;
+  obj.val = "c\n";
+  BOOST_CHECK_EQUAL(encoded_size(custom_codec(), obj), encode(custom_codec(), obj).size());
+}
+
+BOOST_AUTO_TEST_CASE(json_encoded_size_should_get_size) {
+  custom_obj obj;
+  obj.val = "d";
+  BOOST_CHECK_EQUAL(encoded_size(obj), 9);
+}
+
+BOOST_AUTO_TEST_CASE(json_encoded_size_should_get_size_with_codec_without_encoded_size) {
+  custom_obj obj;
+  obj.val = "e";
+  BOOST_CHECK_EQUAL(encoded_size(nested_codec(), obj), encode(nested_codec(), obj).size());
+}
+
+/*
+ * json::encode into a buffer
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_buffer_with_custom_codec) {
+  custom_obj obj;
+  obj.val = "c";
+  char buffer[16];
+  const auto size = encode(custom_codec(), obj, buffer, sizeof(buffer));
+  BOOST_CHECK_EQUAL(std::string(buffer, size), R"({"a":"c"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_buffer) {
+  custom_obj obj;
+  obj.val = "d";
+  std::vector<char> buffer(65536);
+  const auto size = encode(obj, buffer.data(), buffer.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), size), R"({"x":"d"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_buffer_that_fits_exactly) {
+  const auto value = std::vector<std::string>(100, std::string(300, 'x') + "\n");
+  const auto expected = encode(value);
+  std::vector<char> buffer(expected.size());
+  const auto size = encode(value, buffer.data(), buffer.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), size), expected);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_large_encoded_value_into_buffer) {
+  const auto value = encode_value(std::vector<int>(5000, 1234));
+  BOOST_REQUIRE_GT(value.size(), 2 * detail::max_encode_reservation);
+  std::vector<char> buffer(1024 * 1024);
+  const auto size = encode(value, buffer.data(), buffer.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), size), std::string(value.data(), value.size()));
+  BOOST_CHECK_EQUAL(encoded_size(value), value.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_large_lazy_value_into_buffer) {
+  const auto json = encode(std::vector<int>(5000, 1234));
+  const auto value = decode<lazy<std::vector<int>>>(json);
+  std::vector<char> buffer(1024 * 1024);
+  const auto size = encode(value, buffer.data(), buffer.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), size), json);
+
+  std::vector<char> exact_buffer(json.size());
+  BOOST_CHECK_EQUAL(encode(value, exact_buffer.data(), exact_buffer.size()), json.size());
+  BOOST_CHECK_EQUAL(encoded_size(value), json.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_not_encode_into_buffer_that_is_too_small) {
+  custom_obj obj;
+  obj.val = "d";
+  char buffer[8];
+  BOOST_CHECK_THROW(encode(obj, buffer, sizeof(buffer)), encode_exception);
+
+  const auto value = std::vector<std::string>(100, std::string(300, 'x'));
+  std::vector<char> large_buffer(encode(value).size() - 1);
+  BOOST_CHECK_THROW(encode(value, large_buffer.data(), large_buffer.size()), encode_exception);
+}
+
 /*
  * json::encode_value
  */
@@ -20,6 +20,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/encode_exception.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
@@ -157,5 +158,34 @@ BOOST_AUTO_TEST_CASE(json_encode_context_should_reset_when_data_is_stolen) {
   BOOST_CHECK_EQUAL(ctx.data()[0], '2');
 }
 
+BOOST_AUTO_TEST_CASE(json_encode_context_should_write_into_given_buffer) {
+  char buffer[4];
+  encode_context ctx(buffer, sizeof(buffer));
+  ctx.append("abc", 3);
+  BOOST_CHECK_EQUAL(ctx.data(), buffer);
+  BOOST_CHECK_EQUAL(ctx.capacity(), 4);
+  BOOST_CHECK_EQUAL(std::string(buffer, 3), "abc");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_not_grow_given_buffer) {
+  char buffer[4];
+  encode_context ctx(buffer, sizeof(buffer));
+  ctx.append("abcd", 4);
+  BOOST_CHECK_THROW(ctx.append('e'), encode_exception);
+  BOOST_CHECK_EQUAL(ctx.data(), buffer);
+  BOOST_CHECK_EQUAL(ctx.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_copy_given_buffer_when_data_is_stolen) {
+  char buffer[4];
+  encode_context ctx(buffer, sizeof(buffer));
+  ctx.append('1');
+  const auto stolen_data = ctx.steal_data();
+  BOOST_CHECK_NE(stolen_data.get(), static_cast<void *>(buffer));
+  BOOST_CHECK_EQUAL(static_cast<char *>(stolen_data.get())[0], '1');
+  BOOST_CHECK(ctx.empty());
+  BOOST_CHECK_EQUAL(ctx.capacity(), 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <double-conversion/double-conversion.h>
+
+#include <spotify/json/detail/encode_float.hpp>
+#include <spotify/json/encode_context.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+std::string encode_shortest(const double value) {
+  encode_context context;
+  encode_double_shortest(context, value);
+  return std::string(context.data(), context.size());
+}
+
+std::string encode_precision(const double value, const unsigned significant_digits) {
+  encode_context context;
+  encode_double_precision(context, value, significant_digits);
+  return std::string(context.data(), context.size());
+}
+
+std::string encode_with_double_conversion(const double value) {
+  using dtoa_converter = double_conversion::DoubleToStringConverter;
+  const dtoa_converter converter(
+      dtoa_converter::UNIQUE_ZERO | dtoa_converter::EMIT_POSITIVE_EXPONENT_SIGN,
+      nullptr, nullptr, 'e', -6, 21, 6, 0);
+  char buffer[32];
+  double_conversion::StringBuilder builder(buffer, sizeof(buffer));
+  converter.ToShortest(value, &builder);
+  return std::string(buffer, builder.position());
+}
+
+/**
+ * The number of digits from the first to the last non-zero digit.
+ */
+unsigned count_significant_digits(const std::string &json) {
+  const auto mantissa = json.substr(0, json.find('e'));
+  const auto first = mantissa.find_first_of("123456789");
+  const auto last = mantissa.find_last_of("123456789");
+  const auto point = mantissa.find('.');
+  const auto has_point_inside = (point != std::string::npos && point > first && point < last);
+  return static_cast<unsigned>(last - first + 1 - has_point_inside);
+}
+
+void verify_shortest(const double value) {
+  const auto json = encode_shortest(value);
+  BOOST_REQUIRE_EQUAL(json, encode_with_double_conversion(value));
+  BOOST_REQUIRE_EQUAL(std::strtod(json.c_str(), nullptr), value);
+}
+
+void verify_precision(const double value, const unsigned significant_digits) {
+  char expected[64];
+  std::snprintf(expected, sizeof(expected), "%.*e", significant_digits - 1, value);
+  const auto json = encode_precision(value, significant_digits);
+  BOOST_REQUIRE_MESSAGE(
+      std::strtod(json.c_str(), nullptr) == std::strtod(expected, nullptr),
+      json << " != " << expected);
+  BOOST_REQUIRE_LE(count_significant_digits(json), significant_digits);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_simple_numbers) {
+  BOOST_CHECK_EQUAL(encode_shortest(0.0), "0");
+  BOOST_CHECK_EQUAL(encode_shortest(-0.0), "0");
+  BOOST_CHECK_EQUAL(encode_shortest(1.0), "1");
+  BOOST_CHECK_EQUAL(encode_shortest(-1.0), "-1");
+  BOOST_CHECK_EQUAL(encode_shortest(0.25), "0.25");
+  BOOST_CHECK_EQUAL(encode_shortest(123.456), "123.456");
+  BOOST_CHECK_EQUAL(encode_shortest(0.1 + 0.2), "0.30000000000000004");
+  BOOST_CHECK_EQUAL(encode_shortest(1e21), "1e+21");
+  BOOST_CHECK_EQUAL(encode_shortest(1e20), "100000000000000000000");
+  BOOST_CHECK_EQUAL(encode_shortest(1e-6), "0.000001");
+  BOOST_CHECK_EQUAL(encode_shortest(1e-7), "1e-7");
+  BOOST_CHECK_EQUAL(encode_shortest(-1.5e-7), "-1.5e-7");
+  BOOST_CHECK_EQUAL(encode_shortest(1e23), "1e+23");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_extreme_numbers) {
+  verify_shortest(std::numeric_limits<double>::max());
+  verify_shortest(std::numeric_limits<double>::min());
+  verify_shortest(std::numeric_limits<double>::denorm_min());
+  verify_shortest(-std::numeric_limits<double>::denorm_min());
+  verify_shortest(2 * std::numeric_limits<double>::denorm_min());
+  verify_shortest(9007199254740992.0);
+  verify_shortest(9007199254740994.0);
+  verify_shortest(static_cast<double>(0.1f));
+  BOOST_CHECK_EQUAL(encode_shortest(std::numeric_limits<double>::denorm_min()), "5e-324");
+  BOOST_CHECK_EQUAL(encode_shortest(std::numeric_limits<double>::max()), "1.7976931348623157e+308");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_subnormal_numbers) {
+  for (uint64_t bits = 1; bits < 10000; bits++) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    verify_shortest(value);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_powers_of_two_and_ten) {
+  for (int i = -1074; i <= 1023; i++) {
+    verify_shortest(std::ldexp(1.0, i));
+  }
+  for (int i = -323; i <= 308; i++) {
+    verify_shortest(std::strtod(("1e" + std::to_string(i)).c_str(), nullptr));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_random_numbers_like_double_conversion) {
+  std::mt19937_64 rng(0x5eed);
+  for (int i = 0; i < 200000; i++) {
+    const auto bits = rng();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value)) {
+      verify_shortest(value);
+    }
+  }
+
+  std::uniform_int_distribution<int> cents(-100000, 100000);
+  for (int i = 0; i < 100000; i++) {
+    verify_shortest(cents(rng) / 100.0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_with_limited_precision) {
+  BOOST_CHECK_EQUAL(encode_precision(0.0, 6), "0");
+  BOOST_CHECK_EQUAL(encode_precision(0.5, 6), "0.5");
+  BOOST_CHECK_EQUAL(encode_precision(0.1 + 0.2, 6), "0.3");
+  BOOST_CHECK_EQUAL(encode_precision(3.14159265358979, 6), "3.14159");
+  BOOST_CHECK_EQUAL(encode_precision(-2.718281828459045, 3), "-2.72");
+  BOOST_CHECK_EQUAL(encode_precision(999999.7, 6), "1000000");
+  BOOST_CHECK_EQUAL(encode_precision(123456789.0, 6), "123457000");
+  BOOST_CHECK_EQUAL(encode_precision(1.23456789e-10, 4), "1.235e-10");
+  BOOST_CHECK_EQUAL(encode_precision(1.5, 1), "2");
+  BOOST_CHECK_EQUAL(encode_precision(1e23, 17), "1e+23");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_round_halfway_cases_by_the_exact_value) {
+  // 0.125 is exact, so it is a true tie that rounds to even. 1.0005 and 2.675
+  // are slightly below their decimal representation, so they round down.
+  verify_precision(0.125, 2);
+  verify_precision(1.0005, 4);
+  verify_precision(2.675, 3);
+  verify_precision(1.0000000000000002, 16);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_float_should_encode_random_numbers_with_limited_precision) {
+  std::mt19937_64 rng(0x5eed);
+  std::uniform_int_distribution<unsigned> precision(1, 17);
+  for (int i = 0; i < 100000; i++) {
+    const auto bits = rng();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value) && value != 0.0) {
+      verify_precision(value, precision(rng));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/encode_exception.hpp>
+#include <spotify/json/encode_sink.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using value_type = std::vector<std::map<std::string, std::vector<int>>>;
+
+value_type generate_value() {
+  value_type value(20);
+  for (size_t i = 0; i < value.size(); i++) {
+    for (size_t j = 0; j < i % 4; j++) {
+      value[i]["key" + std::to_string(j)] = std::vector<int>(i % 3, int(i * j));
+    }
+  }
+  return value;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_get_same_output_for_all_buffer_sizes) {
+  const auto value = generate_value();
+  const auto expected = encode(value);
+  for (size_t buffer_size = 1; buffer_size < 64; buffer_size++) {
+    std::string output;
+    size_t num_writes = 0;
+    callback_sink sink([&](const char *data, size_t size) {
+      output.append(data, size);
+      num_writes++;
+    });
+    encode(default_codec<value_type>(), value, sink, buffer_size);
+    BOOST_REQUIRE_EQUAL(output, expected);
+    BOOST_CHECK_GT(num_writes, expected.size() / (buffer_size + 16));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_keep_buffer_size) {
+  const auto value = std::vector<std::string>(1000, "spotify:track:05341EWu6uHUg2BojF3Cyw");
+  size_t size = 0;
+  callback_sink sink([&](const char *, size_t s) { size += s; });
+  encode_context context(sink, 256);
+  default_codec<std::vector<std::string>>().encode(context, value);
+  BOOST_CHECK_EQUAL(context.capacity(), 256);
+  context.flush();
+  BOOST_CHECK(context.empty());
+  BOOST_CHECK_EQUAL(size, encode(value).size());
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_grow_buffer_for_large_reservations) {
+  std::string output;
+  callback_sink sink([&](const char *data, size_t size) { output.append(data, size); });
+  encode_context context(sink, 16);
+  context.append("ab", 2);
+  std::memset(context.reserve(100), 'x', 100);
+  context.advance(100);
+  context.flush();
+  BOOST_CHECK_EQUAL(output, "ab" + std::string(100, 'x'));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_write_to_ostream) {
+  std::ostringstream stream;
+  ostream_sink sink(stream);
+  encode(default_codec<value_type>(), generate_value(), sink, 32);
+  BOOST_CHECK_EQUAL(stream.str(), encode(generate_value()));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_write_to_buffer) {
+  const auto expected = encode(generate_value());
+  std::vector<char> buffer(expected.size());
+  buffer_sink sink(buffer.data(), buffer.size());
+  encode(default_codec<value_type>(), generate_value(), sink, 32);
+  BOOST_CHECK_EQUAL(sink.size(), expected.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), buffer.size()), expected);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_encode_directly_into_buffer) {
+  char buffer[16];
+  buffer_sink sink(buffer, sizeof(buffer));
+  char staging[4];
+  encode_context context(sink, staging, sizeof(staging));
+  context.append("0123456789", 10);
+  BOOST_CHECK(context.data() == buffer);
+  context.append("abcdef", 6);
+  context.flush();
+  BOOST_CHECK_EQUAL(sink.size(), 16);
+  BOOST_CHECK_EQUAL(std::string(buffer, sizeof(buffer)), "0123456789abcdef");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_throw_when_buffer_is_full) {
+  char buffer[4];
+  buffer_sink sink(buffer, sizeof(buffer));
+  sink.write("abc", 3);
+  BOOST_CHECK_THROW(sink.write("de", 2), encode_exception);
+  BOOST_CHECK_EQUAL(sink.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_gather_buffers) {
+  gather_sink sink;
+  encode(default_codec<value_type>(), generate_value(), sink, 32);
+  std::string output;
+  for (const auto &buffer : sink.buffers()) {
+    BOOST_CHECK_LE(buffer.size, 32);
+    output.append(buffer.data, buffer.size);
+  }
+  BOOST_CHECK_EQUAL(output, encode(generate_value()));
+  BOOST_CHECK_EQUAL(sink.size(), output.size());
+  sink.clear();
+  BOOST_CHECK(sink.buffers().empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_gather_sink_should_keep_buffers_valid_when_written_to) {
+  gather_sink sink;
+  sink.write("a", 1);  // short enough to be stored inline in the block
+  const auto first = sink.buffers().front();
+  for (auto i = 0; i < 1000; i++) {
+    sink.write("bc", 2);
+  }
+
+  BOOST_CHECK(sink.buffers().front().data == first.data);
+  BOOST_CHECK_EQUAL(std::string(first.data, first.size), "a");
+}
+
+#if !defined(_WIN32)
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_write_to_file_descriptor) {
+  const auto file = std::tmpfile();
+  BOOST_REQUIRE(file);
+  fd_sink sink(fileno(file));
+  encode(default_codec<value_type>(), generate_value(), sink, 32);
+
+  std::string output(encode(generate_value()).size() + 1, '\0');
+  std::rewind(file);
+  output.resize(std::fread(&output[0], 1, output.size(), file));
+  std::fclose(file);
+  BOOST_CHECK_EQUAL(output, encode(generate_value()));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_sink_should_throw_when_file_descriptor_fails) {
+  fd_sink sink(-1);
+  BOOST_CHECK_THROW(encode(default_codec<value_type>(), generate_value(), sink), std::system_error);
+}
+
+#endif  // !defined(_WIN32)
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
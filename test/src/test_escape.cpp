@@ -14,6 +14,7 @@
  * the License.
  */
 
+#include <random>
 #include <string>
 #include <vector>
 
@@ -21,7 +22,10 @@
 #include <boost/range/join.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/utf8.hpp>
+#include <spotify/json/encode_exception.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
@@ -30,10 +34,92 @@ BOOST_AUTO_TEST_SUITE(detail)
 using namespace std;
 using namespace boost;
 
-void check_escaped(const std::string &expected, const std::string &input) {
+using escape_function = void (*)(encode_context &, const char *, const char *);
+
+/**
+ * All write_escaped implementations that can run on this CPU, including the
+ * dispatching one that is used by the codecs.
+ */
+std::vector<escape_function> escape_kernels() {
+  std::vector<escape_function> kernels;
+  kernels.push_back(&write_escaped);
+  kernels.push_back(&write_escaped_scalar);
+#if defined(json_arch_x86)
+  if (cpuid().has_sse42()) {
+    kernels.push_back(&write_escaped_sse42);
+  }
+  if (cpuid().has_avx2()) {
+    kernels.push_back(&write_escaped_avx2);
+  }
+#endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+  if (cpuid().has_avx512bw()) {
+    kernels.push_back(&write_escaped_avx512);
+  }
+#endif  // defined(json_simd_avx512)
+#if defined(json_arch_arm64)
+  if (cpuid().has_neon()) {
+    kernels.push_back(&write_escaped_neon);
+  }
+#endif  // defined(json_arch_arm64)
+  return kernels;
+}
+
+/**
+ * All write_escaped implementations that validate UTF-8 and that can run on
+ * this CPU, including the dispatching one (which validates when the context
+ * says so).
+ */
+std::vector<escape_function> utf8_escape_kernels() {
+  std::vector<escape_function> kernels;
+  kernels.push_back(&write_escaped);
+  kernels.push_back(&write_escaped_utf8_scalar);
+#if defined(json_arch_x86)
+  if (cpuid().has_avx2()) {
+    kernels.push_back(&write_escaped_utf8_avx2);
+  }
+#endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+  if (cpuid().has_avx512bw()) {
+    kernels.push_back(&write_escaped_utf8_avx512);
+  }
+#endif  // defined(json_simd_avx512)
+  return kernels;
+}
+
+/**
+ * Escape the input with all validating kernels, and check that they either
+ * write what write_escaped_scalar writes, or fail if the input is not valid.
+ */
+void check_escaped_utf8(const std::string &input) {
+  const auto end = input.data() + input.size();
+  const auto is_valid = (find_invalid_utf8(input.data(), end) == end);
+  encode_context expected_context;
+  write_escaped_scalar(expected_context, input.data(), end);
+  const auto expected = std::string(expected_context.data(), expected_context.size());
+
+  for (const auto kernel : utf8_escape_kernels()) {
+    encode_context context;
+    context.set_validate_utf8(true);
+    if (is_valid) {
+      kernel(context, input.data(), end);
+      BOOST_REQUIRE_EQUAL(expected, std::string(context.data(), context.size()));
+    } else {
+      BOOST_REQUIRE_THROW(kernel(context, input.data(), end), encode_exception);
+    }
+  }
+}
+
+std::string escaped(const escape_function kernel, const std::string &input) {
   encode_context context;
-  write_escaped(context, input.data(), input.data() + input.size());
-  BOOST_CHECK_EQUAL(expected, std::string(context.data(), context.size()));
+  kernel(context, input.data(), input.data() + input.size());
+  return std::string(context.data(), context.size());
+}
+
+void check_escaped(const std::string &expected, const std::string &input) {
+  for (const auto kernel : escape_kernels()) {
+    BOOST_CHECK_EQUAL(expected, escaped(kernel, input));
+  }
 }
 
 BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_special_characters) {
@@ -65,9 +151,104 @@ BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_other_control_characters)
 }
 
 BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_zero_sized_nullptr) {
-  encode_context context;
-  write_escaped(context, nullptr, 0);
-  BOOST_CHECK_EQUAL(0, context.size());
+  for (const auto kernel : escape_kernels()) {
+    encode_context context;
+    kernel(context, nullptr, 0);
+    BOOST_CHECK_EQUAL(0, context.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_long_strings) {
+  const std::string specials("\"\\\t\x01\x1F");
+  for (size_t size = 0; size < 100; size++) {
+    for (size_t offset = 0; offset < size; offset += 7) {
+      std::string input(size, 'a');
+      input[offset] = specials[offset % specials.size()];
+      check_escaped(escaped(&write_escaped_scalar, input), input);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_strings_with_many_special_characters) {
+  const std::string specials("\"\\\t\x01\x1F\0");
+  for (size_t size = 0; size < 200; size++) {
+    std::string input;
+    for (size_t i = 0; i < size; i++) {
+      input += ((i * 7) % 5 < 2 ? specials[i % specials.size()] : char('a' + i % 26));
+    }
+    check_escaped(escaped(&write_escaped_scalar, input), input);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_strings_with_only_special_characters) {
+  for (size_t size = 0; size < 200; size++) {
+    const std::string input(size, '\x02');
+    check_escaped(escaped(&write_escaped_scalar, input), input);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_at_any_alignment) {
+  const std::string padded(300, 'x');
+  for (size_t offset = 0; offset < 64; offset++) {
+    auto input = padded;
+    input[offset + 100] = '"';
+    input[offset + 200] = '\n';
+    const auto begin = input.data() + offset;
+    const auto end = begin + 230;
+    const auto expected = escaped(&write_escaped_scalar, std::string(begin, end));
+    for (const auto kernel : escape_kernels()) {
+      encode_context context;
+      kernel(context, begin, end);
+      BOOST_CHECK_EQUAL(expected, std::string(context.data(), context.size()));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_accept_valid_utf8) {
+  const std::string chars("a\xC3\xA5\xE2\x82\xAC\xF0\x9F\x8E\xB5\t\"");
+  for (size_t size = 0; size < 300; size++) {
+    std::string input;
+    while (input.size() < size) {
+      input += chars;
+    }
+    check_escaped_utf8(input);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_reject_invalid_utf8) {
+  const std::string invalid_sequences[] = {
+    "\x80", "\xFF", "\xC0\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80",
+    "\xC3", "\xE2\x82", "\xF0\x9F\x8E"
+  };
+  for (const auto &invalid : invalid_sequences) {
+    for (size_t offset = 0; offset < 140; offset++) {
+      const auto prefix = std::string(offset, (offset % 3) ? 'a' : '\n');
+      check_escaped_utf8(prefix + invalid);
+      check_escaped_utf8(prefix + invalid + std::string(70, 'a'));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_validate_random_utf8) {
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<int> kind(0, 60);
+  std::uniform_int_distribution<int> byte(0x80, 0xFF);
+  std::uniform_int_distribution<size_t> size(0, 200);
+  for (int i = 0; i < 20000; i++) {
+    std::string input;
+    const auto n = size(rng);
+    while (input.size() < n) {
+      switch (kind(rng) % 6) {
+        case 0: input += "a"; break;
+        case 1: input += "\xC3\xA5"; break;
+        case 2: input += "\xE2\x82\xAC"; break;
+        case 3: input += "\xF0\x9F\x8E\xB5"; break;
+        case 4: input += "\""; break;
+        default: input += (kind(rng) == 0 ? char(byte(rng)) : 'b'); break;
+      }
+    }
+    check_escaped_utf8(input);
+  }
 }
 
 BOOST_AUTO_TEST_SUITE_END()  // detail
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/key_matcher.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+size_t find(const key_matcher &matcher, const std::string &key) {
+  return matcher.find(key.data(), key.data() + key.size());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(key_matcher_should_not_find_keys_when_empty) {
+  key_matcher matcher;
+  BOOST_CHECK_EQUAL(matcher.size(), 0);
+  BOOST_CHECK_EQUAL(find(matcher, ""), key_matcher::npos);
+  BOOST_CHECK_EQUAL(find(matcher, "a"), key_matcher::npos);
+}
+
+BOOST_AUTO_TEST_CASE(key_matcher_should_find_keys_by_insertion_index) {
+  key_matcher matcher;
+  BOOST_CHECK(matcher.insert("a"));
+  BOOST_CHECK(matcher.insert(""));
+  BOOST_CHECK(matcher.insert("a_long_key_that_is_longer_than_16_bytes"));
+  BOOST_CHECK_EQUAL(matcher.size(), 3);
+  BOOST_CHECK_EQUAL(find(matcher, "a"), 0);
+  BOOST_CHECK_EQUAL(find(matcher, ""), 1);
+  BOOST_CHECK_EQUAL(find(matcher, "a_long_key_that_is_longer_than_16_bytes"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(key_matcher_should_not_insert_duplicate_keys) {
+  key_matcher matcher;
+  BOOST_CHECK(matcher.insert("a"));
+  BOOST_CHECK(!matcher.insert("a"));
+  BOOST_CHECK_EQUAL(matcher.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(key_matcher_should_tell_apart_keys_with_same_head_and_tail) {
+  key_matcher matcher;
+  BOOST_CHECK(matcher.insert("01234567_a_89abcdef"));
+  BOOST_CHECK(matcher.insert("01234567_b_89abcdef"));
+  BOOST_CHECK_EQUAL(find(matcher, "01234567_a_89abcdef"), 0);
+  BOOST_CHECK_EQUAL(find(matcher, "01234567_b_89abcdef"), 1);
+  BOOST_CHECK_EQUAL(find(matcher, "01234567_c_89abcdef"), key_matcher::npos);
+  BOOST_CHECK_EQUAL(find(matcher, "01234567_89abcdef"), key_matcher::npos);
+}
+
+BOOST_AUTO_TEST_CASE(key_matcher_should_find_many_keys) {
+  key_matcher matcher;
+  for (size_t i = 0; i < 1000; i++) {
+    BOOST_CHECK(matcher.insert(std::to_string(i)));
+  }
+
+  for (size_t i = 0; i < 1000; i++) {
+    BOOST_CHECK_EQUAL(find(matcher, std::to_string(i)), i);
+  }
+
+  BOOST_CHECK_EQUAL(find(matcher, "1000"), key_matcher::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
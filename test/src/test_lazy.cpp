@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/lazy.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct playlist_t {
+  int id = 0;
+  json::lazy<std::vector<std::string>> tracks;
+};
+
+object_t<playlist_t> playlist_codec() {
+  object_t<playlist_t> codec;
+  codec.required("id", &playlist_t::id);
+  codec.optional("tracks", &playlist_t::tracks);
+  return codec;
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_decode_on_first_access) {
+  const auto value = decode<json::lazy<std::vector<int>>>("[1, 2, 3]");
+  BOOST_CHECK(!value.is_decoded());
+  BOOST_REQUIRE_EQUAL(value->size(), 3);
+  BOOST_CHECK(value.is_decoded());
+  BOOST_CHECK_EQUAL((*value)[2], 3);
+  BOOST_CHECK_EQUAL(&value.get(), &value.get());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_decode_fields_on_first_access) {
+  const std::string json = R"({"tracks":["a","b"],"id":7})";
+  const auto playlist = decode(playlist_codec(), json);
+  BOOST_CHECK_EQUAL(playlist.id, 7);
+  BOOST_CHECK(!playlist.tracks.is_decoded());
+  BOOST_REQUIRE_EQUAL(playlist.tracks->size(), 2);
+  BOOST_CHECK_EQUAL(playlist.tracks->back(), "b");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_fail_on_first_access) {
+  const std::string json = R"({"tracks":["a",2],"id":7})";
+  const auto playlist = decode(playlist_codec(), json);
+  BOOST_CHECK_THROW(playlist.tracks.get(), decode_exception);
+  BOOST_CHECK(!playlist.tracks.is_decoded());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_still_check_that_the_value_is_json) {
+  BOOST_CHECK_THROW(decode(playlist_codec(), R"({"tracks":["a" "b"],"id":7})"), decode_exception);
+  BOOST_CHECK_THROW(decode(playlist_codec(), R"({"tracks":["a",)"), decode_exception);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_encode_undecoded_values_as_is) {
+  const std::string json = R"({"id":7,"tracks":[ "a" , "b" ]})";
+  const auto codec = playlist_codec();
+  const auto playlist = decode(codec, json);
+  BOOST_CHECK_EQUAL(encode(codec, playlist), json);
+  BOOST_CHECK_EQUAL(playlist.tracks->size(), 2);
+  BOOST_CHECK_EQUAL(encode(codec, playlist), json);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_encode_assigned_values) {
+  const auto codec = playlist_codec();
+  auto playlist = decode(codec, R"({"id":7,"tracks":[ "a" ]})");
+  playlist.tracks = std::vector<std::string>{ "c" };
+  BOOST_CHECK(playlist.tracks.is_decoded());
+  BOOST_CHECK_EQUAL(encode(codec, playlist), R"({"id":7,"tracks":["c"]})");
+  BOOST_CHECK_EQUAL(encode(json::lazy<int>()), "0");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_use_should_encode_of_inner_codec) {
+  object_t<json::lazy<std::shared_ptr<int>>> codec;
+  codec.optional("a", [](const json::lazy<std::shared_ptr<int>> &value) {
+    return value;
+  }, [](json::lazy<std::shared_ptr<int>> &, json::lazy<std::shared_ptr<int>> &&) {});
+  BOOST_CHECK_EQUAL(encode(codec, json::lazy<std::shared_ptr<int>>()), "{}");
+  BOOST_CHECK_EQUAL(encode(codec, json::lazy<std::shared_ptr<int>>(std::make_shared<int>(1))), R"({"a":1})");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
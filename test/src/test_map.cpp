@@ -14,7 +14,9 @@
  * the License.
  */
 
+#include <map>
 #include <string>
+#include <unordered_map>
 
 #include <boost/test/unit_test.hpp>
 
@@ -138,6 +140,58 @@ BOOST_AUTO_TEST_CASE(json_codec_map_should_respect_should_encode) {
   BOOST_CHECK_EQUAL(encode(codec, map), R"({"a":true})");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_map_should_have_encoded_size) {
+  std::map<std::string, bool> map;
+  BOOST_CHECK_EQUAL(default_codec<decltype(map)>().encoded_size(map), 2);
+  map["a"] = true;
+  map["b\n"] = false;
+  BOOST_CHECK_EQUAL(default_codec<decltype(map)>().encoded_size(map), encode(map).size());
+
+  const auto codec = codec::map<std::map<std::string, bool>>(only_true_t());
+  BOOST_CHECK_EQUAL(codec.encoded_size(map), encode(codec, map).size());
+}
+
+/*
+ * Decoding in place
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_into_existing_map) {
+  std::map<std::string, bool> value{ { "x", true }, { "a", false } };
+  decode_into(default_codec<std::map<std::string, bool>>(), R"({"a":true,"b":false})", value);
+  BOOST_CHECK(value == (std::map<std::string, bool>{ { "a", true }, { "b", false } }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_into_existing_unordered_map) {
+  using map_type = std::unordered_map<std::string, bool>;
+  map_type value;
+  value.reserve(64);
+  const auto bucket_count = value.bucket_count();
+  decode_into(default_codec<map_type>(), R"({"a":true,"b":false})", value);
+  BOOST_CHECK(value == (map_type{ { "a", true }, { "b", false } }));
+  BOOST_CHECK_EQUAL(value.bucket_count(), bucket_count);
+}
+
+/*
+ * Reserving
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_reserve_the_previously_decoded_size) {
+  using map_type = std::unordered_map<std::string, bool>;
+  std::string json = "{";
+  for (int i = 0; i < 1000; i++) {
+    json += (i ? ",\"" : "\"") + std::to_string(i) + "\":true";
+  }
+  json += "}";
+
+  const auto codec = default_codec<map_type>();
+  decode(codec, json);
+  map_type reserved;
+  reserved.reserve(1000);
+  const auto value = decode(codec, json);
+  BOOST_CHECK_EQUAL(value.size(), 1000);
+  BOOST_CHECK_EQUAL(value.bucket_count(), reserved.bucket_count());
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -116,6 +116,23 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_with_rounding_errors) {
   BOOST_CHECK_EQUAL(test_decode(number<float>(), "1.1"), 1.1f);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_numbers_with_many_digits) {
+  BOOST_CHECK_EQUAL(test_decode(number<double>(), "3.14159265358979323846264338327950288"), 3.14159265358979323846264338327950288);
+  BOOST_CHECK_EQUAL(test_decode(number<float>(), "3.14159265358979323846264338327950288"), 3.14159265358979323846264338327950288f);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_numbers_with_large_exponents) {
+  BOOST_CHECK_EQUAL(test_decode(number<double>(), "1.5e300"), 1.5e300);
+  BOOST_CHECK_EQUAL(test_decode(number<double>(), "-4.9e-324"), -4.9e-324);
+  BOOST_CHECK_EQUAL(test_decode(number<double>(), "1e-400"), 0.0);
+  BOOST_CHECK_EQUAL(test_decode(number<float>(), "1e-50"), 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_not_gobble_after_float_numbers) {
+  BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<double>(), "0.25,", 4), 0.25);
+  BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<float>(), "-2e3]", 4), -2e3f);
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_number_should_not_decode_invalid_float_numbers) {
   test_decode_fail(number<double>(), "");
   test_decode_fail(number<double>(), " 1");
@@ -133,6 +150,31 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_exactly) {
   BOOST_CHECK_EQUAL(encode(0.5f), "0.5");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_shortest_round_trip) {
+  BOOST_CHECK_EQUAL(encode(0.1), "0.1");
+  BOOST_CHECK_EQUAL(encode(-0.0), "0");
+  BOOST_CHECK_EQUAL(encode(1e21), "1e+21");
+  BOOST_CHECK_EQUAL(encode(1.5e-7), "1.5e-7");
+  BOOST_CHECK_EQUAL(encode(0.1f), "0.10000000149011612");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_with_significant_digits) {
+  BOOST_CHECK_EQUAL(encode(number<double>(6), 3.14159265358979), "3.14159");
+  BOOST_CHECK_EQUAL(encode(number<double>(6), 0.25), "0.25");
+  BOOST_CHECK_EQUAL(encode(number<double>(2), -1234.5), "-1200");
+  BOOST_CHECK_EQUAL(encode(number<float>(6), 0.1f), "0.1");
+  BOOST_CHECK_THROW(encode(number<double>(6), NAN), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_have_encoded_size_of_floating_point_numbers) {
+  for (const auto value : { 0.0, 0.5, -0.1, 1e21, 1.5e-7, 0.1 + 0.2, -1.7976931348623157e308 }) {
+    BOOST_CHECK_EQUAL(number<double>().encoded_size(value), encode(value).size());
+    BOOST_CHECK_EQUAL(number<double>(3).encoded_size(value), encode(number<double>(3), value).size());
+  }
+  BOOST_CHECK_EQUAL(number<float>().encoded_size(0.1f), 19);
+  BOOST_CHECK_THROW(number<double>().encoded_size(NAN), encode_exception);
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_number_should_not_encode_not_a_number) {
   BOOST_CHECK_THROW(encode(number<float>(), NAN), encode_exception);
   BOOST_CHECK_THROW(encode(number<double>(), NAN), encode_exception);
@@ -372,6 +414,47 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_not_gobble_characters_after_unsign
   BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<uint8_t>(), "15.0#", 4), 15);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_long_integers) {
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "1466547200000"), 1466547200000LL);
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "-1466547200000"), -1466547200000LL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "12345678"), 12345678ULL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "123456789"), 123456789ULL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "1234567890123456"), 1234567890123456ULL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "12345678901234567"), 12345678901234567ULL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "1234567890123456789"), 1234567890123456789ULL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "10000000000000000000"), 10000000000000000000ULL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint32_t>(), "000000000000000000042"), 42U);
+  BOOST_CHECK_EQUAL(test_decode(number<int32_t>(), "-2147483648"), INT32_MIN);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_long_integers_followed_by_other_characters) {
+  BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<int64_t>(), "123456789012,\"a\"", 12), 123456789012LL);
+  BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<int64_t>(), "12345678]       ", 8), 12345678LL);
+  BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<int64_t>(), "1234567,89012345", 7), 1234567LL);
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "1234567890123.75"), 1234567890123LL);
+  BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "123456789012345e3"), 123456789012345000LL);
+  BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), "123456789012345678901234e-5"), 1234567890123456789ULL);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_not_decode_overflowing_long_integers) {
+  test_decode_fail(number<uint64_t>(), "18446744073709551616");
+  test_decode_fail(number<uint64_t>(), "99999999999999999999");
+  test_decode_fail(number<int64_t>(), "12345678901234567890123");
+  test_decode_fail(number<uint32_t>(), "12345678901");
+  test_decode_fail(number<int32_t>(), "-12345678901");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_decode_integers_of_all_lengths) {
+  uint64_t value = 0;
+  for (int num_digits = 1; num_digits <= 19; num_digits++) {
+    value = value * 10 + (num_digits % 10);
+    const auto json = std::to_string(value);
+    BOOST_CHECK_EQUAL(test_decode(number<uint64_t>(), json), value);
+    BOOST_CHECK_EQUAL(test_decode(number<int64_t>(), "-" + json), -static_cast<int64_t>(value));
+    BOOST_CHECK_EQUAL(test_decode_dont_gobble(number<uint64_t>(), json + ",1234567", json.size()), value);
+  }
+}
+
 /*
  * Encoding Unsigned Integers
  */
@@ -384,6 +467,47 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_unsigned_positive_integer)
   BOOST_CHECK_EQUAL(encode(number<uint64_t>(), UINT64_MAX), "18446744073709551615");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_integers_of_all_lengths) {
+  uint64_t power_of_ten = 1;
+  for (int num_digits = 1; num_digits <= 19; num_digits++) {
+    for (const auto value : { power_of_ten, power_of_ten * 9 + (power_of_ten - 1) }) {
+      BOOST_CHECK_EQUAL(encode(number<uint64_t>(), value), std::to_string(value));
+      if (value <= INT64_MAX) {
+        BOOST_CHECK_EQUAL(encode(number<int64_t>(), -static_cast<int64_t>(value)), "-" + std::to_string(value));
+      }
+      if (value <= UINT32_MAX) {
+        BOOST_CHECK_EQUAL(encode(number<uint32_t>(), static_cast<uint32_t>(value)), std::to_string(value));
+      }
+      if (value <= INT32_MAX) {
+        BOOST_CHECK_EQUAL(encode(number<int32_t>(), -static_cast<int32_t>(value)), "-" + std::to_string(value));
+      }
+    }
+    power_of_ten *= 10;
+  }
+  BOOST_CHECK_EQUAL(encode(number<uint64_t>(), power_of_ten), "10000000000000000000");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_have_encoded_size_of_integers) {
+  uint64_t power_of_ten = 1;
+  for (int num_digits = 1; num_digits <= 19; num_digits++) {
+    for (const auto value : { power_of_ten, power_of_ten * 9 + (power_of_ten - 1) }) {
+      BOOST_CHECK_EQUAL(number<uint64_t>().encoded_size(value), num_digits);
+      if (value <= INT64_MAX) {
+        BOOST_CHECK_EQUAL(number<int64_t>().encoded_size(-static_cast<int64_t>(value)), num_digits + 1);
+      }
+      if (value <= UINT32_MAX) {
+        BOOST_CHECK_EQUAL(number<uint32_t>().encoded_size(static_cast<uint32_t>(value)), num_digits);
+      }
+    }
+    power_of_ten *= 10;
+  }
+  BOOST_CHECK_EQUAL(number<uint64_t>().encoded_size(0), 1);
+  BOOST_CHECK_EQUAL(number<uint64_t>().encoded_size(UINT64_MAX), 20);
+  BOOST_CHECK_EQUAL(number<int64_t>().encoded_size(INT64_MIN), 20);
+  BOOST_CHECK_EQUAL(number<int32_t>().encoded_size(INT32_MIN), 11);
+  BOOST_CHECK_EQUAL(number<int8_t>().encoded_size(-128), 4);
+}
+
 /*
  * Decoding size_t
  */
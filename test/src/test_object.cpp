@@ -19,6 +19,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/any_value.hpp>
+#include <spotify/json/codec/array.hpp>
 #include <spotify/json/codec/boolean.hpp>
 #include <spotify/json/codec/object.hpp>
 #include <spotify/json/codec/string.hpp>
@@ -133,6 +135,70 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_fields) {
   BOOST_CHECK_EQUAL(simple.size, 123456);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_fields_with_escaped_keys) {
+  const auto simple = test_decode(default_codec<simple_t>(), R"({"val\u0075e":"hey","\u0073ize":1})");
+  BOOST_CHECK_EQUAL(simple.value, "hey");
+  BOOST_CHECK_EQUAL(simple.size, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_skip_unknown_fields) {
+  const auto simple = test_decode(default_codec<simple_t>(), R"({"valu":1,"values":[],"\"":{},"":2,"size":3})");
+  BOOST_CHECK_EQUAL(simple.size, 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_skip_unknown_fields_unchecked) {
+  auto codec = default_codec<simple_t>();
+  codec.skip_unknown_fields_unchecked();
+  const auto simple = test_decode(codec, R"({"a":{"b":["}",1 2]},"c":[1,,],"size":3,"d":"]"})");
+  BOOST_CHECK_EQUAL(simple.size, 3);
+  test_decode_fail(codec, R"({"size":3,"a":{"b":"}]})");
+  test_decode_fail(default_codec<simple_t>(), R"({"a":{"b":["}",1 2]},"size":3})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_decode_unterminated_keys) {
+  test_decode_fail(default_codec<simple_t>(), R"({"value)");
+  test_decode_fail(default_codec<simple_t>(), R"({"val\)");
+  test_decode_fail(default_codec<simple_t>(), R"({value:"hey"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_predict_fields_in_order) {
+  auto codec = default_codec<simple_t>();
+  codec.count_predictions();
+  test_decode(codec, R"({"size":1,"value":"a"})");
+  test_decode(codec, R"({ "size" : 1 , "value" : "a" })");
+  BOOST_CHECK_EQUAL(codec.predictions().hits, 4);
+  BOOST_CHECK_EQUAL(codec.predictions().misses, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_count_mispredicted_fields) {
+  auto codec = default_codec<simple_t>();
+  codec.count_predictions();
+  const auto simple = test_decode(codec, R"({"value":"a","size":1,"x":0,"\u0073ize":2})");
+  BOOST_CHECK_EQUAL(simple.value, "a");
+  BOOST_CHECK_EQUAL(simple.size, 2);
+  BOOST_CHECK_EQUAL(codec.predictions().hits, 0);
+  BOOST_CHECK_EQUAL(codec.predictions().misses, 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_predict_key_prefixes) {
+  object_t<simple_t> codec;
+  codec.optional("val", &simple_t::value);
+  codec.optional("value", &simple_t::size);
+  codec.count_predictions();
+  const auto simple = test_decode(codec, R"({"value":1,"val":"a"})");
+  BOOST_CHECK_EQUAL(simple.size, 1);
+  BOOST_CHECK_EQUAL(simple.value, "a");
+  BOOST_CHECK_EQUAL(codec.predictions().hits, 0);
+  BOOST_CHECK_EQUAL(codec.predictions().misses, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_count_predictions_by_default) {
+  const auto codec = default_codec<simple_t>();
+  test_decode(codec, R"({"size":1,"value":"a"})");
+  BOOST_CHECK_EQUAL(codec.predictions().hits, 0);
+  BOOST_CHECK_EQUAL(codec.predictions().misses, 0);
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_object_should_require_required_fields) {
   test_decode_fail(example_codec(), "{}");
 }
@@ -223,6 +289,54 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_respect_should_encode) {
   BOOST_CHECK_EQUAL(encode(codec, data), R"({"first":true})");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_object_should_respect_should_encode_between_other_fields) {
+  using data_t = std::pair<bool, bool>;
+
+  codec::object_t<data_t> codec;
+  codec.optional("a", &data_t::first, only_true_t());
+  codec.required("b", &data_t::first);
+  codec.optional("c", &data_t::second, only_true_t());
+  codec.optional("d", &data_t::first, only_true_t());
+  codec.required("e", &data_t::second);
+  codec.optional("f", &data_t::second, only_true_t());
+
+  BOOST_CHECK_EQUAL(encode(codec, data_t(true, true)),
+      R"({"a":true,"b":true,"c":true,"d":true,"e":true,"f":true})");
+  BOOST_CHECK_EQUAL(encode(codec, data_t(true, false)),
+      R"({"a":true,"b":true,"d":true,"e":false})");
+  BOOST_CHECK_EQUAL(encode(codec, data_t(false, true)),
+      R"({"b":false,"c":true,"e":true,"f":true})");
+  BOOST_CHECK_EQUAL(encode(codec, data_t(false, false)),
+      R"({"b":false,"e":false})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_omit_all_fields_when_encoding) {
+  using data_t = std::pair<bool, bool>;
+
+  codec::object_t<data_t> codec;
+  codec.optional("a", &data_t::first, only_true_t());
+  codec.optional("b", &data_t::second, only_true_t());
+
+  BOOST_CHECK_EQUAL(encode(codec, data_t(false, false)), "{}");
+  BOOST_CHECK_EQUAL(encode(codec, data_t(false, true)), R"({"b":true})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_into_buffer_that_fits_exactly) {
+  struct wrapper_t {
+    encoded_value value;
+  };
+
+  object_t<wrapper_t> codec;
+  codec.required("a", &wrapper_t::value);
+  wrapper_t wrapper;
+  wrapper.value = encoded_value("[1,2]");
+
+  char buffer[11];
+  encode_context context(buffer, sizeof(buffer));
+  codec.encode(context, wrapper);
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), R"({"a":[1,2]})");
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_fields_in_provided_order) {
   simple_t simple;
   simple.value = "";
@@ -268,6 +382,107 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_lambda_getter_field) {
   BOOST_CHECK_EQUAL(encode(codec, getset), R"({"value":"foobar"})");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_object_should_have_encoded_size) {
+  simple_t simple;
+  simple.value = "hey\"";
+  simple.size = 123456789;
+  BOOST_CHECK_EQUAL(default_codec<simple_t>().encoded_size(simple), encode(simple).size());
+
+  using data_t = std::pair<bool, bool>;
+  codec::object_t<data_t> only_true;
+  only_true.optional("first", &data_t::first, only_true_t());
+  only_true.required("second", &data_t::second, only_true_t());
+  BOOST_CHECK_EQUAL(only_true.encoded_size(data_t(false, false)), 2);
+  BOOST_CHECK_EQUAL(only_true.encoded_size(data_t(true, false)), 14);
+
+  object_t<example_t> dummy;
+  dummy.required("dummy", string());
+  BOOST_CHECK_EQUAL(dummy.encoded_size(example_t()), 12);
+
+  getset_t getset;
+  getset.set_value("foobar");
+  BOOST_CHECK_EQUAL(getset_codec().encoded_size(getset), 18);
+  BOOST_CHECK_EQUAL(getset_lambda_codec().encoded_size(getset), 18);
+}
+
+/*
+ * Decoding in place
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_existing_object) {
+  example_t value;
+  value.value.assign(64, 'x');
+  value.simple.value.assign(64, 'y');
+  const auto value_data = value.value.data();
+  const auto simple_value_data = value.simple.value.data();
+
+  decode_into(example_codec(), R"({"simple":{"size":5,"value":"b"},"value":"a"})", value);
+  BOOST_CHECK_EQUAL(value.value, "a");
+  BOOST_CHECK_EQUAL(value.simple.size, 5);
+  BOOST_CHECK_EQUAL(value.simple.value, "b");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(value.value.data()), static_cast<const void *>(value_data));
+  BOOST_CHECK_EQUAL(
+      static_cast<const void *>(value.simple.value.data()),
+      static_cast<const void *>(simple_value_data));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_reset_missing_fields_when_decoding_into_existing_object) {
+  struct reused_t {
+    int id = 7;
+    std::vector<int> items;
+    std::string name;
+  };
+
+  object_t<reused_t> codec;
+  codec.optional("id", &reused_t::id);
+  codec.optional("items", &reused_t::items);
+  codec.optional("name", &reused_t::name);
+
+  reused_t value;
+  decode_into(codec, R"({"id":1,"items":[1,2,3],"name":"a long name, to not be inline"})", value);
+  const auto items_data = value.items.data();
+  const auto name_capacity = value.name.capacity();
+  decode_into(codec, R"({"name":"b"})", value);
+  BOOST_CHECK_EQUAL(value.id, 7);
+  BOOST_CHECK(value.items.empty());
+  BOOST_CHECK_EQUAL(value.name, "b");
+  decode_into(codec, R"({})", value);
+  BOOST_CHECK_EQUAL(value.name, "");
+  BOOST_CHECK_EQUAL(value.name.capacity(), name_capacity);
+  decode_into(codec, R"({"items":[4]})", value);
+  BOOST_CHECK_EQUAL(value.items.data(), items_data);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_reset_missing_fields_with_setters_when_decoding_into_existing_object) {
+  object_t<getset_t> codec;
+  codec.optional("value", &getset_t::get_value, &getset_t::set_value);
+  object_t<getset_t> lambda_codec;
+  lambda_codec.optional("value",
+                        [](const getset_t &x) { return x.get_value(); },
+                        [](getset_t &x, const std::string &value) { x.set_value(value); });
+
+  getset_t value;
+  decode_into(codec, R"({"value":"a"})", value);
+  decode_into(codec, R"({})", value);
+  BOOST_CHECK_EQUAL(value.get_value(), "");
+  decode_into(lambda_codec, R"({"value":"b"})", value);
+  decode_into(lambda_codec, R"({})", value);
+  BOOST_CHECK_EQUAL(value.get_value(), "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_existing_object_with_setters) {
+  getset_t value;
+  decode_into(getset_codec(), R"({"value":"a"})", value);
+  BOOST_CHECK_EQUAL(value.get_value(), "a");
+  decode_into(getset_lambda_codec(), R"({"value":"b"})", value);
+  BOOST_CHECK_EQUAL(value.get_value(), "b");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_require_fields_when_decoding_into_existing_object) {
+  example_t value;
+  BOOST_CHECK_THROW(decode_into(example_codec(), R"({"simple":{}})", value), decode_exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
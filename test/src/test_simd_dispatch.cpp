@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/cpuid.hpp>
+#include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/simd_dispatch.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+BOOST_AUTO_TEST_CASE(json_simd_dispatch_should_be_resolved_once) {
+  BOOST_CHECK(&simd() == &simd());
+}
+
+BOOST_AUTO_TEST_CASE(json_simd_dispatch_should_have_all_kernels) {
+  BOOST_CHECK(simd().skip_any_simple_characters != nullptr);
+  BOOST_CHECK(simd().skip_any_whitespace != nullptr);
+  BOOST_CHECK(simd().write_escaped != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(json_simd_dispatch_should_be_deterministic) {
+  const auto dispatch = resolve_simd_dispatch();
+  BOOST_CHECK(dispatch.skip_any_simple_characters == simd().skip_any_simple_characters);
+  BOOST_CHECK(dispatch.skip_any_simple_characters_utf8 == simd().skip_any_simple_characters_utf8);
+  BOOST_CHECK(dispatch.skip_any_whitespace == simd().skip_any_whitespace);
+  BOOST_CHECK(dispatch.write_escaped == simd().write_escaped);
+  BOOST_CHECK(dispatch.write_escaped_utf8 == simd().write_escaped_utf8);
+}
+
+#if defined(json_arch_x86)
+
+BOOST_AUTO_TEST_CASE(json_simd_dispatch_should_use_widest_escape_kernel) {
+  const cpuid cpu;
+  auto expected = &write_escaped_scalar;
+  auto expected_utf8 = &write_escaped_utf8_scalar;
+  if (cpu.has_sse42()) {
+    expected = &write_escaped_sse42;
+  }
+  if (cpu.has_avx2()) {
+    expected = &write_escaped_avx2;
+    expected_utf8 = &write_escaped_utf8_avx2;
+  }
+#if defined(json_simd_avx512)
+  if (cpu.has_avx512bw()) {
+    expected = &write_escaped_avx512;
+    expected_utf8 = &write_escaped_utf8_avx512;
+  }
+#endif  // defined(json_simd_avx512)
+
+  BOOST_CHECK(simd().write_escaped == expected);
+  BOOST_CHECK(simd().write_escaped_utf8 == expected_utf8);
+}
+
+BOOST_AUTO_TEST_CASE(json_simd_dispatch_should_use_widest_skip_kernels) {
+  const cpuid cpu;
+  auto expected_simple = &skip_any_simple_characters_scalar;
+  auto expected_whitespace = &skip_any_whitespace_scalar;
+  if (cpu.has_sse2()) {
+    expected_simple = &skip_any_simple_characters_sse2;
+    expected_whitespace = &skip_any_whitespace_sse2;
+  }
+  if (cpu.has_sse42()) {
+    expected_simple = &skip_any_simple_characters_sse42;
+    expected_whitespace = &skip_any_whitespace_sse42;
+  }
+  if (cpu.has_avx2()) {
+    expected_simple = &skip_any_simple_characters_avx2;
+    expected_whitespace = &skip_any_whitespace_avx2;
+  }
+#if defined(json_simd_avx512)
+  if (cpu.has_avx512bw()) {
+    expected_simple = &skip_any_simple_characters_avx512;
+    expected_whitespace = &skip_any_whitespace_avx512;
+  }
+#endif  // defined(json_simd_avx512)
+
+  BOOST_CHECK(simd().skip_any_simple_characters == expected_simple);
+  BOOST_CHECK(simd().skip_any_whitespace == expected_whitespace);
+}
+
+#endif  // defined(json_arch_x86)
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
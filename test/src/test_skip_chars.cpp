@@ -14,12 +14,17 @@
  * the License.
  */
 
+#include <algorithm>
 #include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
 
-#include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/utf8.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
@@ -36,14 +41,100 @@ std::string generate(const std::string &tpl, const std::size_t count) {
   return ws;
 }
 
-template <void (*function)(decode_context &)>
+using skip_function = void (*)(decode_context &);
+
+/**
+ * All skip_any_simple_characters implementations that can run on this CPU,
+ * including the dispatching one that is used by the codecs.
+ */
+std::vector<skip_function> simple_characters_kernels() {
+  std::vector<skip_function> kernels;
+  kernels.push_back(&skip_any_simple_characters);
+  kernels.push_back(&skip_any_simple_characters_scalar);
+#if defined(json_arch_x86)
+  if (cpuid().has_sse2()) {
+    kernels.push_back(&skip_any_simple_characters_sse2);
+  }
+  if (cpuid().has_sse42()) {
+    kernels.push_back(&skip_any_simple_characters_sse42);
+  }
+  if (cpuid().has_avx2()) {
+    kernels.push_back(&skip_any_simple_characters_avx2);
+  }
+#endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+  if (cpuid().has_avx512bw()) {
+    kernels.push_back(&skip_any_simple_characters_avx512);
+  }
+#endif  // defined(json_simd_avx512)
+#if defined(json_arch_arm64)
+  if (cpuid().has_neon()) {
+    kernels.push_back(&skip_any_simple_characters_neon);
+  }
+#endif  // defined(json_arch_arm64)
+  return kernels;
+}
+
+/**
+ * All skip_any_simple_characters implementations that validate UTF-8 and that
+ * can run on this CPU, including the dispatching one (which validates when the
+ * context says so).
+ */
+std::vector<skip_function> utf8_simple_characters_kernels() {
+  std::vector<skip_function> kernels;
+  kernels.push_back(&skip_any_simple_characters);
+  kernels.push_back(&skip_any_simple_characters_utf8_scalar);
+#if defined(json_arch_x86)
+  if (cpuid().has_avx2()) {
+    kernels.push_back(&skip_any_simple_characters_utf8_avx2);
+  }
+#endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+  if (cpuid().has_avx512bw()) {
+    kernels.push_back(&skip_any_simple_characters_utf8_avx512);
+  }
+#endif  // defined(json_simd_avx512)
+  return kernels;
+}
+
+/**
+ * All skip_any_whitespace implementations that can run on this CPU, including
+ * the dispatching one that is used by the codecs.
+ */
+std::vector<skip_function> whitespace_kernels() {
+  std::vector<skip_function> kernels;
+  kernels.push_back(&skip_any_whitespace);
+  kernels.push_back(&skip_any_whitespace_scalar);
+#if defined(json_arch_x86)
+  if (cpuid().has_sse2()) {
+    kernels.push_back(&skip_any_whitespace_sse2);
+  }
+  if (cpuid().has_sse42()) {
+    kernels.push_back(&skip_any_whitespace_sse42);
+  }
+  if (cpuid().has_avx2()) {
+    kernels.push_back(&skip_any_whitespace_avx2);
+  }
+#endif  // defined(json_arch_x86)
+#if defined(json_simd_avx512)
+  if (cpuid().has_avx512bw()) {
+    kernels.push_back(&skip_any_whitespace_avx512);
+  }
+#endif  // defined(json_simd_avx512)
+#if defined(json_arch_arm64)
+  if (cpuid().has_neon()) {
+    kernels.push_back(&skip_any_whitespace_neon);
+  }
+#endif  // defined(json_arch_arm64)
+  return kernels;
+}
+
 void verify_skip_any(
-    const bool use_sse,
+    const skip_function function,
     const std::string &json,
     const std::size_t prefix = 0,
     const std::size_t suffix = 0) {
   auto context = decode_context(json.data() + prefix, json.data() + json.size());
-  *const_cast<bool *>(&context.has_sse42) &= use_sse;
   const auto original_context = context;
   function(context);
   BOOST_CHECK_EQUAL(
@@ -54,101 +145,167 @@ void verify_skip_any(
       reinterpret_cast<intptr_t>(original_context.end));
 }
 
-template <void (*function)(decode_context &)>
-void verify_skip_empty_nullptr(const bool use_sse) {
+void verify_skip_empty_nullptr(const skip_function function) {
   auto context = decode_context(nullptr, nullptr);
-  *const_cast<bool *>(&context.has_sse42) &= use_sse;
   function(context);
   BOOST_CHECK(context.position == nullptr);
   BOOST_CHECK(context.end == nullptr);
 }
 
-using true_false = boost::mpl::list<boost::true_type, boost::false_type>;
-
-}  // namespace
+void verify_skip_whitespace(const std::string &tpl) {
+  for (const auto kernel : whitespace_kernels()) {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate(tpl, n);
+      const auto with_prefix = "}" + ws;
+      const auto with_suffix = ws + "{ ";
+      verify_skip_any(kernel, ws);
+      verify_skip_any(kernel, with_prefix, 1);
+      verify_skip_any(kernel, with_suffix, 0, 2);
+    }
+  }
+}
 
-/*
- * skip_any_simple_characters
+/**
+ * Skip the string with a validating kernel and check that it either stops at
+ * the first " or \, or fails at the first invalid UTF-8 sequence before it.
  */
+void verify_skip_utf8(const skip_function function, const std::string &json) {
+  const auto begin = json.data();
+  const auto end = begin + json.size();
+  const auto stop = std::min(std::min(json.find('"'), json.find('\\')), json.size());
+  const auto invalid = find_invalid_utf8(begin, begin + stop);
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("abcdefghIJKLMNOP:-,;'^¨´`xyz", n);
-    const auto with_prefix = "\\" + ws;
-    const auto with_suffix = ws + "\"abcde";
-    verify_skip_any<skip_any_simple_characters>(use_sse::value, ws);
-    verify_skip_any<skip_any_simple_characters>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_simple_characters>(use_sse::value, with_suffix, 0, 6);
+  auto context = decode_context(begin, end);
+  context.validate_utf8 = true;
+  if (invalid == begin + stop) {
+    function(context);
+    BOOST_REQUIRE_EQUAL(context.offset(), stop);
+  } else {
+    try {
+      function(context);
+      BOOST_FAIL("Expected a decode_exception for " << json.size() << " bytes");
+    } catch (const decode_exception &exception) {
+      BOOST_REQUIRE_EQUAL(exception.offset(), invalid - begin);
+    }
   }
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_with_empty_string,
-                              use_sse,
-                              true_false) {
-  verify_skip_empty_nullptr<skip_any_simple_characters>(use_sse::value);
+/**
+ * A string of random characters, most of which are valid UTF-8 sequences of
+ * one to four bytes, with an occasional random byte.
+ */
+std::string generate_utf8(std::mt19937 &rng, const std::size_t size) {
+  std::uniform_int_distribution<int> kind(0, 40);
+  std::uniform_int_distribution<int> byte(0x80, 0xFF);
+  std::string string;
+  while (string.size() < size) {
+    switch (kind(rng) % 5) {
+      case 0: string += "a"; break;
+      case 1: string += "\xC3\xA5"; break;
+      case 2: string += "\xE2\x82\xAC"; break;
+      case 3: string += "\xF0\x9F\x8E\xB5"; break;
+      default: string += (kind(rng) == 0 ? char(byte(rng)) : 'b'); break;
+    }
+  }
+  return string;
 }
 
+}  // namespace
+
 /*
- * skip_any_whitespace
+ * skip_any_simple_characters
  */
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_space, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate(" ", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters) {
+  for (const auto kernel : simple_characters_kernels()) {
+    for (auto n = 0; n < 1024; n++) {
+      const auto ws = generate("abcdefghIJKLMNOP:-,;'^¨´`xyz", n);
+      const auto with_prefix = "\\" + ws;
+      const auto with_suffix = ws + "\"abcde";
+      verify_skip_any(kernel, ws);
+      verify_skip_any(kernel, with_prefix, 1);
+      verify_skip_any(kernel, with_suffix, 0, 6);
+    }
   }
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_tabs, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\t", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_with_empty_string) {
+  for (const auto kernel : simple_characters_kernels()) {
+    verify_skip_empty_nullptr(kernel);
   }
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_carriage_return, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\r", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_should_accept_valid_utf8) {
+  for (const auto kernel : utf8_simple_characters_kernels()) {
+    for (auto n = 0; n < 300; n++) {
+      const auto chars = generate("a\xC3\xA5\xE2\x82\xAC\xF0\x9F\x8E\xB5", n * 10);
+      verify_skip_utf8(kernel, chars);
+      verify_skip_utf8(kernel, chars + "\"");
+      verify_skip_utf8(kernel, chars + "\\\xFF");  // invalid after the backslash
+    }
+    verify_skip_empty_nullptr(kernel);
   }
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_line_feed, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\n", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_should_reject_invalid_utf8) {
+  const std::string invalid_sequences[] = {
+    "\x80", "\xFF", "\xC0\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80",
+    "\xC3", "\xE2\x82", "\xF0\x9F\x8E"
+  };
+  for (const auto kernel : utf8_simple_characters_kernels()) {
+    for (const auto &invalid : invalid_sequences) {
+      for (std::size_t offset = 0; offset < 140; offset++) {
+        const auto prefix = std::string(offset, 'a');
+        verify_skip_utf8(kernel, prefix + invalid);
+        verify_skip_utf8(kernel, prefix + invalid + "\"");
+        verify_skip_utf8(kernel, prefix + invalid + std::string(70, 'a') + "\"");
+      }
+    }
   }
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_whitespace, use_sse, true_false) {
-  for (auto n = 0; n < 1024; n++) {
-    const auto ws = generate("\n\t\r\n", n);
-    const auto with_prefix = "}" + ws;
-    const auto with_suffix = ws + "{ ";
-    verify_skip_any<skip_any_whitespace>(use_sse::value, ws);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_prefix, 1);
-    verify_skip_any<skip_any_whitespace>(use_sse::value, with_suffix, 0, 2);
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_should_validate_random_utf8) {
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<std::size_t> size(0, 200);
+  for (int i = 0; i < 20000; i++) {
+    auto json = generate_utf8(rng, size(rng));
+    if (i % 2) {
+      json += "\"\xFF";
+    }
+    for (const auto kernel : utf8_simple_characters_kernels()) {
+      verify_skip_utf8(kernel, json);
+    }
   }
 }
 
-BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_whitespace_with_empty_string, use_sse, true_false) {
-  verify_skip_empty_nullptr<skip_any_whitespace>(use_sse::value);
+/*
+ * skip_any_whitespace
+ */
+
+BOOST_AUTO_TEST_CASE(json_skip_any_space) {
+  verify_skip_whitespace(" ");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_tabs) {
+  verify_skip_whitespace("\t");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_carriage_return) {
+  verify_skip_whitespace("\r");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_line_feed) {
+  verify_skip_whitespace("\n");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_whitespace) {
+  verify_skip_whitespace("\n\t\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_whitespace_with_empty_string) {
+  for (const auto kernel : whitespace_kernels()) {
+    verify_skip_empty_nullptr(kernel);
+  }
 }
 
 BOOST_AUTO_TEST_SUITE_END()  // detail
@@ -14,6 +14,8 @@
  * the License.
  */
 
+#include <string>
+
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/detail/skip_value.hpp>
@@ -30,11 +32,31 @@ void verify_skip_fail(const std::string &json) {
 }
 
 void verify_skip_value(const std::string &json, const size_t extra = 0) {
+  for (const auto skip_unchecked : { false, true }) {
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.skip_unchecked = skip_unchecked;
+    const auto original_context = context;
+    skip_value(context);
+    BOOST_CHECK_EQUAL(context.position, original_context.end - extra);
+    BOOST_CHECK_EQUAL(context.end, original_context.end);
+  }
+}
+
+void verify_skip_unchecked(const std::string &json, const size_t extra = 0) {
+  auto context = decode_context(json.data(), json.data() + json.size());
+  skip_value_unchecked(context);
+  BOOST_CHECK_EQUAL(context.position, context.end - extra);
+}
+
+void verify_skip_unchecked_fail(const std::string &json) {
   auto context = decode_context(json.data(), json.data() + json.size());
-  const auto original_context = context;
-  skip_value(context);
-  BOOST_CHECK_EQUAL(context.position, original_context.end - extra);
-  BOOST_CHECK_EQUAL(context.end, original_context.end);
+  BOOST_CHECK_THROW(skip_value_unchecked(context), decode_exception);
+}
+
+void verify_skip_utf8_fail(const std::string &json) {
+  auto context = decode_context(json.data(), json.data() + json.size());
+  context.validate_utf8 = true;
+  BOOST_CHECK_THROW(skip_value(context), decode_exception);
 }
 
 }  // namespace
@@ -45,6 +67,13 @@ BOOST_AUTO_TEST_CASE(json_skip_value_string) {
   verify_skip_value(u8"\"\u9E21\"");
 }
 
+BOOST_AUTO_TEST_CASE(json_skip_value_should_validate_utf8) {
+  verify_skip_value("\"\xC3\"");
+  verify_skip_utf8_fail("\"\xC3\"");
+  verify_skip_utf8_fail("{\"a\":[1,\"b\\n\xFF\"]}");
+  verify_skip_utf8_fail("{\"\xC0\x80\":1}");
+}
+
 BOOST_AUTO_TEST_CASE(json_skip_value_number) {
   verify_skip_value("0");
   verify_skip_value("1");
@@ -98,6 +127,45 @@ BOOST_AUTO_TEST_CASE(json_skip_value_nested_object) {
   verify_skip_value(R"({"a":[{},[]]})");
 }
 
+BOOST_AUTO_TEST_CASE(json_skip_value_should_skip_unchecked_containers) {
+  verify_skip_unchecked(R"({"a":"}]"})");
+  verify_skip_unchecked(R"(["\"]", "\\", "\\\"]"] 1)", 2);
+  verify_skip_unchecked(R"({"a":[{"b":"{"}],"c":{}}, {})", 4);
+  verify_skip_unchecked(std::string(200, '[') + std::string(200, ']'));
+  verify_skip_unchecked("12, 3", 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_should_skip_unchecked_containers_across_blocks) {
+  for (size_t i = 0; i < 140; i++) {
+    const auto padding = std::string(i, ' ');
+    verify_skip_value("[" + padding + R"("a\\\"]\\",{"b":["}"]},"\\"])" + " 1", 2);
+    verify_skip_value("{" + padding + R"("\u005c":{"c":"\"\"\\"}})" + " 1", 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_should_not_check_unchecked_containers) {
+  verify_skip_unchecked(R"({true:false})");
+  verify_skip_unchecked("[,]");
+  verify_skip_unchecked("[1 2 3}");
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_should_not_skip_unterminated_unchecked_containers) {
+  verify_skip_unchecked_fail("");
+  verify_skip_unchecked_fail("[");
+  verify_skip_unchecked_fail(R"(["]")");
+  verify_skip_unchecked_fail(R"({"a":[1,2})");
+  verify_skip_unchecked_fail(std::string(100, '[') + std::string(99, ']'));
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_value_should_validate_utf8_in_unchecked_containers) {
+  const std::string json = "[\"\xC3\"]";
+  verify_skip_unchecked(json);
+  auto context = decode_context(json.data(), json.data() + json.size());
+  context.skip_unchecked = true;
+  context.validate_utf8 = true;
+  BOOST_CHECK_THROW(skip_value(context), decode_exception);
+}
+
 /*
  * Invalid JSON
  */
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/static_object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/test/only_true.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+template <typename Codec>
+typename Codec::object_type test_decode(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  auto obj = codec.decode(c);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  return obj;
+}
+
+template <typename Codec>
+void test_decode_fail(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  BOOST_CHECK_THROW(codec.decode(c), decode_exception);
+}
+
+struct simple_t {
+  size_t size = 0;
+  std::string value;
+  std::vector<int> values;
+};
+
+struct subclass_t : simple_t {};
+
+auto simple_codec() -> decltype(static_object<simple_t>(
+    required_field("size", &simple_t::size),
+    optional_field("value", &simple_t::value),
+    optional_field("values", &simple_t::values))) {
+  return static_object<simple_t>(
+      required_field("size", &simple_t::size),
+      optional_field("value", &simple_t::value),
+      optional_field("values", &simple_t::values));
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_fields) {
+  const auto simple = test_decode(simple_codec(), R"({"value":"hey","size":123456,"values":[1,2]})");
+  BOOST_CHECK_EQUAL(simple.value, "hey");
+  BOOST_CHECK_EQUAL(simple.size, 123456);
+  BOOST_CHECK_EQUAL(simple.values.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_fields_with_whitespace) {
+  const auto simple = test_decode(simple_codec(), "{ \"size\" : 1 , \"value\" : \"a\" }");
+  BOOST_CHECK_EQUAL(simple.size, 1);
+  BOOST_CHECK_EQUAL(simple.value, "a");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_fields_with_escaped_keys) {
+  const auto simple = test_decode(simple_codec(), R"({"\u0073ize":1,"val\u0075e":"a","val\"ue":"b"})");
+  BOOST_CHECK_EQUAL(simple.size, 1);
+  BOOST_CHECK_EQUAL(simple.value, "a");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_skip_unknown_fields) {
+  const auto simple = test_decode(simple_codec(), R"({"valu":1,"value_":[],"":{},"size":3})");
+  BOOST_CHECK_EQUAL(simple.size, 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_fields_after_unexpected_keys) {
+  const auto simple = test_decode(
+      simple_codec(),
+      "{\"size\":1,\"x\":{\"value\":\"b\"},\n\"value\":\"a\",\"values\":[3],\"size\":2,\"value\":\"c\"}");
+  BOOST_CHECK_EQUAL(simple.size, 2);
+  BOOST_CHECK_EQUAL(simple.value, "c");
+  BOOST_REQUIRE_EQUAL(simple.values.size(), 1);
+  BOOST_CHECK_EQUAL(simple.values[0], 3);
+  test_decode_fail(simple_codec(), R"({"size":1,})");
+  test_decode_fail(simple_codec(), R"({"size":1,"x":1,})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_require_required_fields) {
+  test_decode_fail(simple_codec(), "{}");
+  test_decode_fail(simple_codec(), R"({"value":"hey"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_overwrite_duplicate_fields) {
+  const auto simple = test_decode(simple_codec(), R"({"size":1,"size":2})");
+  BOOST_CHECK_EQUAL(simple.size, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_not_decode_invalid_objects) {
+  test_decode_fail(simple_codec(), R"([])");
+  test_decode_fail(simple_codec(), R"({"size":1)");
+  test_decode_fail(simple_codec(), R"({"size" 1})");
+  test_decode_fail(simple_codec(), R"({"size":"1"})");
+  test_decode_fail(simple_codec(), R"({size:1})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_use_provided_codec) {
+  const auto codec = static_object<simple_t>(
+      required_field("size", &simple_t::size, number<size_t>()),
+      optional_field("v", &simple_t::value, string()));
+  const auto simple = test_decode(codec, R"({"size":5,"v":"Hello!"})");
+  BOOST_CHECK_EQUAL(simple.value, "Hello!");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_work_with_base_class_member_ptr) {
+  const auto codec = static_object<subclass_t>(optional_field("value", &subclass_t::value));
+  subclass_t subclass;
+  subclass.value = "foobar";
+
+  BOOST_CHECK_EQUAL(decode(codec, encode(codec, subclass)).value, subclass.value);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_without_fields) {
+  test_decode(static_object<simple_t>(), R"({"size":1})");
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_encode_fields_in_provided_order) {
+  simple_t simple;
+  simple.size = 123456789;
+  simple.value = "h\"ey";
+  simple.values = { 1 };
+  BOOST_CHECK_EQUAL(encode(simple_codec(), simple), R"({"size":123456789,"value":"h\"ey","values":[1]})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_respect_should_encode) {
+  using data_t = std::pair<bool, bool>;
+  const auto data = data_t(true, false);
+  const auto codec = static_object<data_t>(
+      optional_field("first", &data_t::first, only_true_t()),
+      required_field("second", &data_t::second, only_true_t()));
+
+  BOOST_CHECK_EQUAL(encode(codec, data), R"({"first":true})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_encode_without_fields) {
+  BOOST_CHECK_EQUAL(encode(static_object<simple_t>(), simple_t()), "{}");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -267,6 +267,131 @@ BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_escaped_control_characters)
   BOOST_CHECK_EQUAL(encode(std::string("\x01\x02")), "\"\\u0001\\u0002\"");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_null_characters) {
+  const auto string = std::string(16, '\0') + std::string(16, 'a');
+  std::string answer = "\"";
+  for (int i = 0; i < 16; i++) {
+    answer += "\\u0000";
+  }
+  BOOST_CHECK_EQUAL(encode(string), answer + std::string(16, 'a') + "\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_have_encoded_size_of_escaped_string) {
+  const auto codec = string();
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::string()), 2);
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::string("\"\\/")), 7);
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::string("\b\t\n\f\r")), 12);
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::string("\x01\x1F")), 14);
+
+  std::string all_characters;
+  for (int c = 0; c < 256; c++) {
+    all_characters.push_back(static_cast<char>(c));
+  }
+  BOOST_CHECK_EQUAL(codec.encoded_size(all_characters), encode(all_characters).size());
+}
+
+/*
+ * Decoding in place
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_into_existing_string) {
+  std::string value(64, 'x');
+  const auto data = value.data();
+  decode_into(string(), R"("abc")", value);
+  BOOST_CHECK_EQUAL(value, "abc");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(value.data()), static_cast<const void *>(data));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_escaped_string_into_existing_string) {
+  std::string value(64, 'x');
+  const auto data = value.data();
+  decode_into(string(), R"("a\nb\u00e5c")", value);
+  BOOST_CHECK_EQUAL(value, "a\nb\xC3\xA5" "c");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(value.data()), static_cast<const void *>(data));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_empty_string_into_existing_string) {
+  std::string value("abc");
+  decode_into(string(), R"("")", value);
+  BOOST_CHECK_EQUAL(value, "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_not_decode_into_existing_string_from_invalid_json) {
+  std::string value;
+  BOOST_CHECK_THROW(decode_into(string(), R"("abc)", value), decode_exception);
+  BOOST_CHECK_THROW(decode_into(string(), R"("a\)", value), decode_exception);
+  BOOST_CHECK_THROW(decode_into(string(), "abc", value), decode_exception);
+}
+
+/*
+ * Validating UTF-8
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_validate_utf8_when_decoding) {
+  const auto decode_validated = [](const std::string &json) {
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.validate_utf8 = true;
+    return string().decode(context);
+  };
+
+  BOOST_CHECK_EQUAL(decode_validated("\"a\xC3\xA5\\n\xE2\x82\xAC\""), "a\xC3\xA5\n\xE2\x82\xAC");
+  BOOST_CHECK_THROW(decode_validated("\"a\xC3\""), decode_exception);
+  BOOST_CHECK_THROW(decode_validated("\"a\xC3\\n\xA5\""), decode_exception);
+  BOOST_CHECK_THROW(decode_validated("\"abc\\n\xED\xA0\x80\""), decode_exception);
+  BOOST_CHECK_EQUAL(string_parse("\"a\xC3\""), "a\xC3");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_surrogate_pairs_when_validating_utf8) {
+  const auto decode_validated = [](const std::string &json) {
+    auto context = decode_context(json.data(), json.data() + json.size());
+    context.validate_utf8 = true;
+    return string().decode(context);
+  };
+
+  const auto decoded = decode_validated(R"("a\ud83d\ude00b")");
+  BOOST_CHECK_EQUAL(decoded, "a\xF0\x9F\x98\x80" "b");
+  encode_context context;
+  context.set_validate_utf8(true);
+  string().encode(context, decoded);
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), "\"a\xF0\x9F\x98\x80" "b\"");
+
+  BOOST_CHECK_THROW(decode_validated(R"("\ud83d")"), decode_exception);
+  BOOST_CHECK_THROW(decode_validated(R"("\ud83dx")"), decode_exception);
+  BOOST_CHECK_THROW(decode_validated(R"("\ud83d\u0041")"), decode_exception);
+  BOOST_CHECK_THROW(decode_validated(R"("\ude00")"), decode_exception);
+  BOOST_CHECK_EQUAL(string_parse(R"("\ude00")"), "\xED\xB8\x80");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_validate_utf8_when_encoding) {
+  const auto encode_validated = [](const std::string &value) {
+    encode_context context;
+    context.set_validate_utf8(true);
+    string().encode(context, value);
+    return std::string(context.data(), context.size());
+  };
+
+  BOOST_CHECK_EQUAL(encode_validated("a\xC3\xA5\n"), "\"a\xC3\xA5\\n\"");
+  BOOST_CHECK_THROW(encode_validated("a\xC3"), encode_exception);
+  BOOST_CHECK_THROW(encode_validated("\xED\xA0\x80"), encode_exception);
+  BOOST_CHECK_EQUAL(encode(std::string("a\xC3")), "\"a\xC3\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_validate_long_utf8_string_when_encoding) {
+  // The string is written in chunks, which must not end in the middle of one
+  // of the multi-byte characters.
+  for (size_t offset = 0; offset < 4; offset++) {
+    std::string value(offset, 'a');
+    while (value.size() < 5000) {
+      value += "\xF0\x9F\x8E\xB5\xE2\x82\xAC\xC3\xA5";
+    }
+
+    encode_context context;
+    context.set_validate_utf8(true);
+    string().encode(context, value);
+    BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), "\"" + value + "\"");
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string_ref.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/string_ref.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct request {
+  json::string_ref method;
+  json::string_ref path;
+  int id = 0;
+};
+
+object_t<request> request_codec() {
+  auto codec = object<request>();
+  codec.required("method", &request::method);
+  codec.required("path", &request::path);
+  codec.optional("id", &request::id);
+  return codec;
+}
+
+json::string_ref string_ref_parse(const char *json) {
+  const auto codec = default_codec<json::string_ref>();
+  auto ctx = decode_context(json, json + strlen(json));
+  const auto result = codec.decode(ctx);
+  BOOST_CHECK_EQUAL(ctx.position, ctx.end);
+  return result;
+}
+
+void string_ref_parse_fail(const char *json) {
+  auto ctx = decode_context(json, json + strlen(json));
+  BOOST_CHECK_THROW(default_codec<json::string_ref>().decode(ctx), decode_exception);
+}
+
+}  // namespace
+
+/*
+ * string_ref
+ */
+
+BOOST_AUTO_TEST_CASE(json_string_ref_should_compare_like_std_string) {
+  const json::string_ref a("abc");
+  const std::string b("abd");
+  BOOST_CHECK(a == "abc");
+  BOOST_CHECK(a != b);
+  BOOST_CHECK(a < b);
+  BOOST_CHECK(json::string_ref("ab") < a);
+  BOOST_CHECK(json::string_ref() < a);
+  BOOST_CHECK(json::string_ref() == "");
+  BOOST_CHECK_EQUAL(a.str(), "abc");
+  BOOST_CHECK_EQUAL(std::hash<json::string_ref>()(a), std::hash<json::string_ref>()(std::string("abc")));
+}
+
+BOOST_AUTO_TEST_CASE(json_string_ref_should_keep_owned_characters_alive_in_copies) {
+  json::string_ref copy;
+  {
+    const auto owning = json::string_ref::owning(std::string("abc"));
+    BOOST_CHECK(owning.is_owning());
+    copy = owning;
+  }
+  BOOST_CHECK(copy.is_owning());
+  BOOST_CHECK_EQUAL(copy, "abc");
+}
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_point_into_the_input) {
+  const char json[] = R"("hello")";
+  const auto ref = string_ref_parse(json);
+  BOOST_CHECK_EQUAL(ref, "hello");
+  BOOST_CHECK_EQUAL(ref.data(), json + 1);
+  BOOST_CHECK(!ref.is_owning());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_decode_empty_string) {
+  const auto ref = string_ref_parse(R"("")");
+  BOOST_CHECK(ref.empty());
+  BOOST_CHECK(!ref.is_owning());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_own_unescaped_strings) {
+  const char json[] = R"("a\"bå\n")";
+  const auto ref = string_ref_parse(json);
+  BOOST_CHECK_EQUAL(ref, "a\"b\xC3\xA5\n");
+  BOOST_CHECK(ref.is_owning());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_not_decode_invalid_strings) {
+  string_ref_parse_fail(R"()");
+  string_ref_parse_fail(R"(")");
+  string_ref_parse_fail(R"("abc)");
+  string_ref_parse_fail(R"("abc\)");
+  string_ref_parse_fail(R"("\q")");
+  string_ref_parse_fail(R"(abc")");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_decode_object_fields) {
+  const std::string json = R"({"method":"GET","path":"\/a\/b","id":7})";
+  const auto decoded = decode(request_codec(), json);
+  BOOST_CHECK_EQUAL(decoded.method, "GET");
+  BOOST_CHECK_EQUAL(decoded.method.data(), json.data() + 11);
+  BOOST_CHECK_EQUAL(decoded.path, "/a/b");
+  BOOST_CHECK(decoded.path.is_owning());
+  BOOST_CHECK_EQUAL(decoded.id, 7);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_decode_map_keys) {
+  const std::string json = R"({"a":1,"bb":2})";
+  const auto decoded = decode<std::map<json::string_ref, int>>(json);
+  BOOST_REQUIRE_EQUAL(decoded.size(), 2);
+  BOOST_CHECK_EQUAL(decoded.begin()->first.data(), json.data() + 2);
+  BOOST_CHECK_EQUAL(decoded.at("a"), 1);
+  BOOST_CHECK_EQUAL(decoded.at("bb"), 2);
+
+  const auto unordered = decode<std::unordered_map<json::string_ref, int>>(json);
+  BOOST_CHECK_EQUAL(unordered.at("a"), 1);
+  BOOST_CHECK_EQUAL(unordered.at("bb"), 2);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_encode_escaped_string) {
+  BOOST_CHECK_EQUAL(encode(json::string_ref("a\"b\n")), R"("a\"b\n")");
+  BOOST_CHECK_EQUAL(encode(json::string_ref()), R"("")");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_encode_object_fields_and_map_keys) {
+  request value;
+  value.method = "POST";
+  value.path = "/";
+  BOOST_CHECK_EQUAL(encode(request_codec(), value), R"({"method":"POST","path":"/","id":0})");
+
+  std::map<json::string_ref, int> map;
+  map["k"] = 1;
+  BOOST_CHECK_EQUAL(encode(map), R"({"k":1})");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
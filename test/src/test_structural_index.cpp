@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/one_of.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/transform.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/structural_index.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * Byte by byte reference for the tokens that a structural_index should find.
+ */
+std::vector<size_t> reference_tokens(const std::string &json) {
+  std::vector<size_t> tokens;
+  auto in_string = false;
+  auto escaped = false;
+  auto after_separator = true;
+
+  for (size_t i = 0; i < json.size(); i++) {
+    const auto c = json[i];
+    if (in_string) {
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        in_string = false;
+      }
+      after_separator = false;
+      continue;
+    }
+
+    switch (c) {
+      case '"':
+        tokens.push_back(i);
+        in_string = true;
+        after_separator = false;
+        break;
+      case '{': case '}': case '[': case ']': case ':': case ',':
+        tokens.push_back(i);
+        after_separator = true;
+        break;
+      case ' ': case '\t': case '\n': case '\r':
+        after_separator = true;
+        break;
+      default:
+        if (after_separator) {
+          tokens.push_back(i);
+        }
+        after_separator = false;
+        break;
+    }
+  }
+
+  return tokens;
+}
+
+std::vector<size_t> indexed_tokens(const std::string &json) {
+  structural_index index(json.data(), json.size());
+  BOOST_REQUIRE(index.valid());
+
+  std::vector<size_t> tokens;
+  for (auto token = index.next_token(index.begin()); token != index.end(); token = index.next_token(token + 1)) {
+    tokens.push_back(token - index.begin());
+  }
+
+  BOOST_CHECK_EQUAL(tokens.size(), index.size());
+  return tokens;
+}
+
+void verify_tokens(const std::string &json) {
+  const auto expected = reference_tokens(json);
+  const auto actual = indexed_tokens(json);
+  BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+}
+
+template <typename codec_type>
+typename codec_type::object_type indexed_decode(const codec_type &codec, const std::string &json) {
+  structural_index index(json.data(), json.size());
+  BOOST_CHECK(index.valid());
+  return decode(codec, index);
+}
+
+struct inner_t {
+  int value = 0;
+};
+
+struct outer_t {
+  std::string name;
+  inner_t inner;
+  std::vector<int> values;
+};
+
+codec::object_t<inner_t> inner_codec() {
+  codec::object_t<inner_t> codec;
+  codec.optional("value", &inner_t::value);
+  return codec;
+}
+
+codec::object_t<outer_t> outer_codec() {
+  codec::object_t<outer_t> codec;
+  codec.optional("name", &outer_t::name);
+  codec.optional("inner", &outer_t::inner, inner_codec());
+  codec.optional("values", &outer_t::values);
+  return codec;
+}
+
+}  // namespace
+
+/*
+ * Tokens
+ */
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_find_tokens) {
+  const std::string json = "{\"a\": [1, true, \"x\"], \"b\" :null}";
+  const auto tokens = indexed_tokens(json);
+  const std::vector<size_t> expected = { 0, 1, 4, 6, 7, 8, 10, 14, 16, 19, 20, 22, 26, 27, 31 };
+  BOOST_CHECK_EQUAL_COLLECTIONS(tokens.begin(), tokens.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_ignore_structural_characters_in_strings) {
+  verify_tokens("[\"{[:,]}\", \"a b\"]");
+  verify_tokens("{\"\\\"\": \"\\\\\", \"\\\\\\\"\": 1}");
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_carry_state_across_blocks) {
+  for (size_t padding = 0; padding < 130; padding++) {
+    for (size_t backslashes = 0; backslashes < 5; backslashes++) {
+      auto json = "[" + std::string(padding, ' ') + "\"" + std::string(2 * backslashes, '\\') + "\\\"]\", 12, \"";
+      json += std::string(padding % 67, 'x') + "\", [true, -1.5e3]]";
+      verify_tokens(json);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_handle_empty_input) {
+  structural_index index("", size_t(0));
+  BOOST_CHECK(index.valid());
+  BOOST_CHECK_EQUAL(index.size(), 0);
+  BOOST_CHECK_EQUAL(index.next_token(index.begin()), index.end());
+}
+
+/*
+ * Validity
+ */
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_be_invalid_for_unbalanced_input) {
+  for (const auto json : { "[1,2", "[1}", "{]", "]", "\"abc", "[\"\\\"]" }) {
+    structural_index index(json, std::strlen(json));
+    BOOST_CHECK(!index.valid());
+    BOOST_CHECK_EQUAL(index.size(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_fall_back_when_invalid) {
+  const std::string json = "[1,2";
+  structural_index index(json.data(), json.size());
+  decode_context context(index);
+  BOOST_CHECK(context.index == nullptr);
+  BOOST_CHECK_THROW(decode(codec::array<std::vector<int>>(codec::number<int>()), index), decode_exception);
+}
+
+/*
+ * Skipping
+ */
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_skip_containers) {
+  const std::string json = "[{\"a\": [[], {}]}, [\"]\"], 1]";
+  structural_index index(json.data(), json.size());
+  BOOST_CHECK_EQUAL(index.skip_container(json.data() + 1) - json.data(), 16);
+  BOOST_CHECK_EQUAL(index.skip_container(json.data() + 18) - json.data(), 23);
+  BOOST_CHECK_EQUAL(index.skip_container(json.data()) - json.data(), json.size());
+  BOOST_CHECK(index.skip_container(json.data() + 3) == nullptr);  // not a token
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_skip_values) {
+  const std::string json = "{ \"a\" : [ 1, { \"b\": \"}\" } ] } ";
+  structural_index index(json.data(), json.size());
+  decode_context context(index);
+  detail::skip_value(context);
+  BOOST_CHECK_EQUAL(context.offset(), json.size() - 1);
+}
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_decode_like_without_index) {
+  const std::string json =
+      "{ \"unknown\" : { \"deep\" : [ [ 1 , 2 ] , { \"x\" : \"]}\" } ] } ,\n"
+      "  \"name\" : \"a \\\"name\\\"\" ,\r\n"
+      "  \"inner\" :\t{ \"skip\" : [ ] , \"value\" : 42 } ,\n"
+      "  \"values\" : [ 1 , 2 , 3 ] }\n";
+
+  const auto expected = decode(outer_codec(), json);
+  const auto actual = indexed_decode(outer_codec(), json);
+  BOOST_CHECK_EQUAL(actual.name, expected.name);
+  BOOST_CHECK_EQUAL(actual.inner.value, expected.inner.value);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      actual.values.begin(), actual.values.end(),
+      expected.values.begin(), expected.values.end());
+  BOOST_CHECK_EQUAL(actual.inner.value, 42);
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_decode_maps) {
+  const std::string json = " { \"a\" : 1 , \"b\" : 2 } ";
+  const auto map = indexed_decode(codec::map<std::map<std::string, int>>(codec::number<int>()), json);
+  BOOST_CHECK_EQUAL(map.size(), 2);
+  BOOST_CHECK_EQUAL(map.at("a"), 1);
+  BOOST_CHECK_EQUAL(map.at("b"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_decode_after_rewind) {
+  const auto codec = codec::one_of(
+      codec::array<std::vector<int>>(codec::number<int>()),
+      codec::transform(
+          codec::array<std::vector<std::string>>(codec::string()),
+          [](const std::vector<int> &) { return std::vector<std::string>(); },
+          [](const std::vector<std::string> &strings) { return std::vector<int>(strings.size()); }));
+
+  const auto values = indexed_decode(codec, "[ \"a\" , \"b\" , \"c\" ]");
+  BOOST_CHECK_EQUAL(values.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_structural_index_should_fail_like_without_index) {
+  const std::string json = "[ 1 , 2 ; 3 ]";
+  structural_index index(json.data(), json.size());
+  BOOST_CHECK(index.valid());
+  BOOST_CHECK_THROW(decode(codec::array<std::vector<int>>(codec::number<int>()), index), decode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -175,6 +175,14 @@ BOOST_AUTO_TEST_CASE(json_codec_tuple_should_not_encode_omitted_elements_tuple)
   BOOST_CHECK_EQUAL(encode(codec, std::make_tuple(false, true)), "[]");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_tuple_should_have_encoded_size) {
+  BOOST_CHECK_EQUAL(default_codec<std::tuple<>>().encoded_size(std::make_tuple()), 2);
+  BOOST_CHECK_EQUAL(default_codec<std::tuple<int>>().encoded_size(std::make_tuple(1)), 3);
+  const auto codec = default_codec<std::tuple<int, bool, std::string>>();
+  BOOST_CHECK_EQUAL(codec.encoded_size(std::make_tuple(1, true, std::string("a"))), 12);
+  BOOST_CHECK_EQUAL(tuple(omit<bool>(), omit<bool>()).encoded_size(std::make_tuple(false, true)), 2);
+}
+
 /*
  * Pair Encoding
  */
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/utf8.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+/**
+ * A straightforward validator to compare find_invalid_utf8 with. It decodes
+ * every sequence and checks the code point, instead of checking the bytes.
+ */
+bool is_valid_utf8(const std::string &string) {
+  static const uint32_t min_code_point[] = { 0, 0x80, 0x800, 0x10000 };
+  std::size_t i = 0;
+  while (i < string.size()) {
+    const auto c = static_cast<uint8_t>(string[i]);
+    std::size_t n;
+    uint32_t code_point;
+    if (c < 0x80) {
+      i++;
+      continue;
+    } else if ((c & 0xE0) == 0xC0) {
+      n = 1;
+      code_point = (c & 0x1F);
+    } else if ((c & 0xF0) == 0xE0) {
+      n = 2;
+      code_point = (c & 0x0F);
+    } else if ((c & 0xF8) == 0xF0) {
+      n = 3;
+      code_point = (c & 0x07);
+    } else {
+      return false;
+    }
+
+    if (i + n >= string.size()) {
+      return false;
+    }
+    for (std::size_t k = 1; k <= n; k++) {
+      const auto b = static_cast<uint8_t>(string[i + k]);
+      if ((b & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (b & 0x3F);
+    }
+    if (code_point < min_code_point[n] ||
+        code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return false;
+    }
+    i += n + 1;
+  }
+  return true;
+}
+
+bool is_valid(const std::string &string) {
+  const auto end = string.data() + string.size();
+  return (find_invalid_utf8(string.data(), end) == end);
+}
+
+std::size_t invalid_offset(const std::string &string) {
+  return find_invalid_utf8(string.data(), string.data() + string.size()) - string.data();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_accept_valid_utf8) {
+  BOOST_CHECK(is_valid(""));
+  BOOST_CHECK(is_valid("hello, world"));
+  BOOST_CHECK(is_valid("\xC3\xA5\xC3\xA4\xC3\xB6"));  // åäö
+  BOOST_CHECK(is_valid("\xE2\x82\xAC"));  // €
+  BOOST_CHECK(is_valid("\xF0\x9F\x8E\xB5"));  // 🎵
+  BOOST_CHECK(is_valid("\xC2\x80"));  // U+0080
+  BOOST_CHECK(is_valid("\xE0\xA0\x80"));  // U+0800
+  BOOST_CHECK(is_valid("\xED\x9F\xBF"));  // U+D7FF
+  BOOST_CHECK(is_valid("\xEE\x80\x80"));  // U+E000
+  BOOST_CHECK(is_valid("\xF0\x90\x80\x80"));  // U+10000
+  BOOST_CHECK(is_valid("\xF4\x8F\xBF\xBF"));  // U+10FFFF
+  BOOST_CHECK(is_valid(std::string("a\0b", 3)));
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_reject_invalid_utf8) {
+  BOOST_CHECK(!is_valid("\x80"));  // continuation byte without a lead byte
+  BOOST_CHECK(!is_valid("\xC3"));  // cut short
+  BOOST_CHECK(!is_valid("\xE2\x82"));  // cut short
+  BOOST_CHECK(!is_valid("\xF0\x9F\x8E"));  // cut short
+  BOOST_CHECK(!is_valid("\xC3" "a"));  // not continued
+  BOOST_CHECK(!is_valid("\xC0\x80"));  // overlong
+  BOOST_CHECK(!is_valid("\xC1\xBF"));  // overlong
+  BOOST_CHECK(!is_valid("\xE0\x9F\xBF"));  // overlong
+  BOOST_CHECK(!is_valid("\xF0\x8F\xBF\xBF"));  // overlong
+  BOOST_CHECK(!is_valid("\xED\xA0\x80"));  // surrogate U+D800
+  BOOST_CHECK(!is_valid("\xED\xBF\xBF"));  // surrogate U+DFFF
+  BOOST_CHECK(!is_valid("\xF4\x90\x80\x80"));  // U+110000
+  BOOST_CHECK(!is_valid("\xF5\x80\x80\x80"));  // invalid lead byte
+  BOOST_CHECK(!is_valid("\xFF"));  // invalid lead byte
+  BOOST_CHECK(!is_valid("\xC3\xA5\xA5"));  // too long
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_find_first_invalid_sequence) {
+  BOOST_CHECK_EQUAL(invalid_offset("abc"), 3);
+  BOOST_CHECK_EQUAL(invalid_offset("abcdefghij\xFF"), 10);
+  BOOST_CHECK_EQUAL(invalid_offset("\xC3\xA5" "abcdefgh\xE2\x82" "a\xFF"), 10);
+  BOOST_CHECK_EQUAL(invalid_offset("\xF0\x9F\x8E\xB5\x80"), 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_check_all_short_sequences) {
+  for (uint32_t i = 0; i < 0x10000; i++) {
+    const char c[] = { char(i >> 8), char(i & 0xFF) };
+    const std::string string(c, 2);
+    BOOST_REQUIRE_EQUAL(is_valid(string), is_valid_utf8(string));
+  }
+
+  for (uint32_t i = 0xE00000; i < 0xF00000; i++) {
+    const char c[] = { char(i >> 16), char((i >> 8) & 0xFF), char(i & 0xFF) };
+    const std::string string(c, 3);
+    BOOST_REQUIRE_EQUAL(is_valid(string), is_valid_utf8(string));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_find_invalid_utf8_should_check_random_strings) {
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<int> byte(0x70, 0xFF);
+  std::uniform_int_distribution<int> length(0, 8);
+  for (int i = 0; i < 200000; i++) {
+    std::string string;
+    const auto n = length(rng);
+    for (int k = 0; k < n; k++) {
+      string += char(byte(rng));
+    }
+    BOOST_REQUIRE_EQUAL(is_valid(string), is_valid_utf8(string));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify